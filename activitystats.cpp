@@ -0,0 +1,118 @@
+#include "activitystats.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <QElapsedTimer>
+#include <QDebug>
+
+namespace {
+constexpr quint32 kMagic = 0x57574141;      // "WWAA"
+constexpr quint32 kVersion = 2;
+constexpr qint64 kDayMs = 24LL * 3600 * 1000;
+constexpr qint64 kHourMs = 3600 * 1000;
+}
+
+void ActivityStats::setBands(const QVector<int> &meters)
+{
+    m_bands = meters;
+    m_rows.fill(-1);
+    for (int i = 0; i < m_bands.size(); ++i) {
+        if (m_bands[i] > 0 && m_bands[i] < int(m_rows.size())) {
+            m_rows[size_t(m_bands[i])] = qint8(i);
+        }
+    }
+    m_counts.clear();
+}
+
+int ActivityStats::bandRow(int meters) const
+{
+    return meters > 0 && meters < int(m_rows.size()) ? m_rows[size_t(meters)] : -1;
+}
+
+void ActivityStats::add(const SpotRecord &record)
+{
+    const int row = bandRow(record.band);
+    if (row < 0 || record.callKey == 0) {
+        return;
+    }
+
+    const int hour = int((record.timestampMs % kDayMs) / kHourMs);
+    auto it = m_counts.find(record.callKey);
+    if (it == m_counts.end()) {
+        it = m_counts.insert(record.callKey, Counts(m_bands.size() * kHours, 0));
+    }
+    ++(*it)[row * kHours + hour];
+}
+
+const ActivityStats::Counts *ActivityStats::counts(quint32 callKey) const
+{
+    const auto it = m_counts.constFind(callKey);
+    return it == m_counts.constEnd() ? nullptr : &it.value();
+}
+
+void ActivityStats::load(const QString &path, const SpotHistory &history)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    m_counts.clear();
+    quint64 covered = 0;
+
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly)) {
+        QDataStream ds(&file);
+        quint32 magic = 0, version = 0, n = 0;
+        QVector<int> bands;
+        ds >> magic >> version >> covered;
+        if (magic == kMagic && version == kVersion) {
+            ds >> bands >> n;
+        }
+        const bool usable = magic == kMagic && version == kVersion && bands == m_bands
+                            && covered <= history.count();
+        if (usable) {
+            for (quint32 i = 0; i < n && ds.status() == QDataStream::Ok; ++i) {
+                quint32 key = 0;
+                Counts c(m_bands.size() * kHours, 0);
+                ds >> key;
+                for (quint32 &v : c) {
+                    ds >> v;
+                }
+                m_counts.insert(key, c);
+            }
+        }
+        if (ds.status() != QDataStream::Ok || !usable) {
+            qWarning() << "Activity stats" << path << "unusable, rebuilding from history";
+            m_counts.clear();
+            covered = 0;
+        }
+    }
+
+    const quint64 total = history.count();
+    history.scanIndices(covered, total, [this](const SpotRecord &rec) {
+        add(rec);
+        return true;
+    });
+
+    qDebug() << "Activity stats:" << m_counts.size() << "stations, folded in"
+             << (total - covered) << "new spots in" << timer.elapsed() << "ms";
+}
+
+bool ActivityStats::save(const QString &path, const SpotHistory &history) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot save activity stats:" << file.errorString();
+        return false;
+    }
+
+    QDataStream ds(&file);
+    ds << kMagic << kVersion << quint64(history.count()) << m_bands << quint32(m_counts.size());
+    for (auto it = m_counts.cbegin(); it != m_counts.cend(); ++it) {
+        ds << it.key();
+        for (quint32 v : it.value()) {
+            ds << v;
+        }
+    }
+    return file.commit();
+}
@@ -0,0 +1,46 @@
+#ifndef ACTIVITYSTATS_H
+#define ACTIVITYSTATS_H
+
+#include "spothistory.h"
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <array>
+
+// Spot counts per callsign x band x UTC hour-of-day.
+//
+// Counts are updated one spot at a time as spots arrive. They are saved to a
+// small sidecar file together with the number of history records they cover,
+// so a restart only folds in the records appended since the last save instead
+// of rescanning the whole history.
+class ActivityStats
+{
+public:
+    static constexpr int kHours = 24;
+    using Counts = QVector<quint32>;        // bands().size() x kHours
+
+    // Band rows, top to bottom, in meters. Set before load(); spots on
+    // other bands are not counted.
+    void setBands(const QVector<int> &meters);
+    const QVector<int> &bands() const { return m_bands; }
+    int bandRow(int meters) const;
+
+    void add(const SpotRecord &record);
+
+    // Loads `path` and catches up with `history`. Rebuilds from scratch if
+    // the file is missing, unreadable, ahead of the history or saved for
+    // other bands.
+    void load(const QString &path, const SpotHistory &history);
+    bool save(const QString &path, const SpotHistory &history) const;
+
+    // nullptr if the station has no spots.
+    const Counts *counts(quint32 callKey) const;
+
+private:
+    QVector<int> m_bands;
+    std::array<qint8, 256> m_rows{};        // meters -> row, -1 if not tracked
+    QHash<quint32, Counts> m_counts;
+};
+
+#endif // ACTIVITYSTATS_H
@@ -0,0 +1,23 @@
+#ifndef APPCONFIG_H
+#define APPCONFIG_H
+
+#include <QString>
+#include <QStringList>
+
+// Settings taken from the command line in main.cpp and handed to MainWindow.
+struct AppConfig {
+    QString awardsFile = "awards.json";
+    QString targetsFile;        // overrides the first award's target list
+    QString snapshotFile = "WWA.snapshot";
+    // WSJT-X / JTDX UDP endpoints, "host:port"; multicast groups are joined.
+    QStringList udpEndpoints = {"127.0.0.1:2333"};
+    QString rbnEndpoint = "telnet.reversebeacon.net:7000";
+    QString rbnCall = "OG3Z";
+    // Award state for other local tools (see sharedstate.h); empty turns it off.
+    QString sharedStateFile = "WWA.state";
+    QString stateSocket = "wwa-state";
+    bool autoReply = false;         // answer CQs from needed stations via WSJT-X Reply
+    bool measureLatency = false;    // log ingest rates and decode latency
+};
+
+#endif // APPCONFIG_H
@@ -0,0 +1,898 @@
+#include "awardengine.h"
+#include "targetlist.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <numeric>
+
+namespace {
+
+// Table and band names end up in SQL text, so keep them to safe characters.
+bool isValidTable(const QString &name)
+{
+    static const QRegularExpression re(R"(^[A-Za-z_][A-Za-z0-9_]*$)");
+    return re.match(name).hasMatch();
+}
+
+bool isValidBand(const QString &name)
+{
+    static const QRegularExpression re(R"(^[0-9]+(\.[0-9]+)?[A-Za-z]*$)");
+    return re.match(name).hasMatch();
+}
+
+constexpr char kSnapshotMagic[8] = {'W', 'W', 'A', 'S', 'N', 'A', 'P', '1'};
+constexpr quint32 kSnapshotVersion = 2;
+
+struct SnapshotHeader {
+    char magic[8];
+    quint32 version;
+    quint32 awardCount;
+    quint64 payloadSize;
+    quint64 checksum;       // FNV-1a over the payload
+};
+
+// Followed by ids, callsign offsets (rows + 1), callsign bytes, the rows in
+// callsign order, masks and worked cells per mode, each padded to 8 bytes.
+struct SnapshotAward {
+    quint64 definitionHash;
+    quint32 rows;
+    quint32 bands;
+    quint32 stringBytes;
+    quint32 modes;
+};
+
+quint64 fnv1a(const char *data, qint64 size, quint64 hash = 14695981039346656037ULL)
+{
+    for (qint64 i = 0; i < size; ++i) {
+        hash ^= quint8(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+quint64 fnv1a(const QByteArray &data, quint64 hash = 14695981039346656037ULL)
+{
+    return fnv1a(data.constData(), data.size(), hash);
+}
+
+void appendPadded(QByteArray &out, const void *data, qint64 size)
+{
+    out.append(static_cast<const char *>(data), int(size));
+    while (out.size() % 8) {
+        out.append('\0');
+    }
+}
+
+} // namespace
+
+AwardDefinition AwardEngine::defaultWwa()
+{
+    AwardDefinition def;
+    def.name = "WWA";
+    def.table = "modes";
+    def.targetsFile = "targets.txt";
+    def.bands = QStringList{"10", "12", "15", "17", "20", "30", "40", "80"};
+    def.modes = {{"CW", 10}, {"PH", 5}, {"FT8", 2}, {"FT4", 2}};
+    return def;
+}
+
+bool AwardEngine::loadDefinitions(const QString &path, QString *error)
+{
+    m_awards.clear();
+    m_index.clear();
+    m_snapshot.reset();
+
+    QFile file(path);
+    if (!file.exists()) {
+        m_awards.append(Award{});
+        m_awards.last().def = defaultWwa();
+        return true;
+    }
+
+    auto fail = [error](const QString &msg) {
+        if (error) {
+            *error = msg;
+        }
+        return false;
+    };
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(file.errorString());
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (doc.isNull()) {
+        return fail(parseError.errorString());
+    }
+
+    const QJsonArray awards = doc.object().value("awards").toArray();
+    for (const QJsonValue &v : awards) {
+        const QJsonObject o = v.toObject();
+        AwardDefinition def;
+        def.name = o.value("name").toString();
+        def.table = o.value("table").toString();
+        def.targetsFile = o.value("targets").toString();
+        for (const QJsonValue &b : o.value("bands").toArray()) {
+            def.bands.append(b.toString());
+        }
+        for (const QJsonValue &m : o.value("modes").toArray()) {
+            const QJsonObject mo = m.toObject();
+            def.modes.append(AwardMode{normalizeMode(mo.value("name").toString()), mo.value("points").toInt()});
+        }
+
+        if (def.name.isEmpty() || !isValidTable(def.table)) {
+            return fail(QString("Award \"%1\": invalid table name \"%2\"").arg(def.name, def.table));
+        }
+        if (def.bands.isEmpty() || def.modes.isEmpty() || def.modes.size() > 8) {
+            return fail(QString("Award \"%1\": needs bands and 1-8 modes").arg(def.name));
+        }
+        for (const QString &band : def.bands) {
+            if (!isValidBand(band)) {
+                return fail(QString("Award \"%1\": invalid band \"%2\"").arg(def.name, band));
+            }
+        }
+        for (const Award &other : m_awards) {
+            if (other.def.table == def.table) {
+                return fail(QString("Award \"%1\": table \"%2\" already used").arg(def.name, def.table));
+            }
+        }
+
+        m_awards.append(Award{});
+        m_awards.last().def = def;
+    }
+
+    if (m_awards.isEmpty()) {
+        return fail("No awards defined");
+    }
+    return true;
+}
+
+bool AwardEngine::setupTables()
+{
+    QSqlDatabase db = database();
+
+    for (Award &a : m_awards) {
+        const AwardDefinition &def = a.def;
+        QString columns = "id INTEGER PRIMARY KEY AUTOINCREMENT, callsign TEXT";
+        for (const QString &band : def.bands) {
+            columns += QString(R"(, "%1" INTEGER)").arg(band);
+        }
+
+        QSqlQuery query(db);
+        if (!query.exec(QString("CREATE TABLE IF NOT EXISTS %1 (%2)").arg(def.table, columns))) {
+            qWarning() << "Failed to create table" << def.table << ":" << query.lastError();
+            return false;
+        }
+
+        // Bands added to a definition later become new columns.
+        const QSqlRecord existing = db.record(def.table);
+        for (const QString &band : def.bands) {
+            if (existing.indexOf(band) >= 0) {
+                continue;
+            }
+            if (!query.exec(QString(R"(ALTER TABLE %1 ADD COLUMN "%2" INTEGER DEFAULT 0)").arg(def.table, band))) {
+                qWarning() << "Failed to add band" << band << "to" << def.table << ":" << query.lastError();
+                return false;
+            }
+        }
+
+        if (def.targetsFile.isEmpty()) {
+            continue;
+        }
+
+        QStringList calls;
+        QString error;
+        if (!TargetList::load(def.targetsFile, &calls, &error)) {
+            qWarning() << "Cannot read target list" << def.targetsFile << "-" << error;
+            continue;   // keep working with what is already in the database
+        }
+
+        a.targets = QSet<QString>(calls.cbegin(), calls.cend());
+        const int added = TargetList::seed(def.table, def.bands, calls, db);
+        if (added < 0) {
+            return false;
+        }
+        if (added > 0) {
+            qDebug() << "Inserted" << added << "calls into" << def.name << "from" << def.targetsFile;
+        }
+    }
+    m_targetsKnown = true;
+    return true;
+}
+
+bool AwardEngine::loadState()
+{
+    // Everything is re-read, so nothing needs to come from the snapshot.
+    for (Award &a : m_awards) {
+        a.mapped = MappedCalls();
+    }
+    m_snapshot.reset();
+
+    for (int i = 0; i < m_awards.size(); ++i) {
+        if (!reloadAward(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AwardEngine::reloadAward(int award)
+{
+    materialize();      // the other awards keep their rows and need an index
+    Award &a = m_awards[award];
+    const int bandCount = a.def.bands.size();
+
+    QString sql = "SELECT id, callsign";
+    for (const QString &band : a.def.bands) {
+        sql += QString(R"(, "%1")").arg(band);
+    }
+    sql += " FROM " + a.def.table;
+
+    QSqlQuery q(database());
+    q.setForwardOnly(true);
+    if (!q.exec(sql)) {
+        qWarning() << "Failed to load award" << a.def.name << ":" << q.lastError();
+        return false;
+    }
+
+    a.ids.clear();
+    a.calls.clear();
+    a.masks.clear();
+    a.rowById.clear();
+    a.modeCounts = QVector<int>(a.def.modes.size(), 0);
+
+    while (q.next()) {
+        const int row = appendRow(a, q.value(0).toLongLong(), q.value(1).toString().trimmed().toUpper());
+        for (int b = 0; b < bandCount; ++b) {
+            setCell(a, row, b, q.value(b + 2).toInt());
+        }
+    }
+
+    rebuildIndex();
+    ++m_generation;
+    return true;
+}
+
+void AwardEngine::rebuildIndex()
+{
+    m_index.clear();
+    for (int award = 0; award < m_awards.size(); ++award) {
+        const QStringList &calls = m_awards[award].calls;
+        for (int row = 0; row < calls.size(); ++row) {
+            if (!calls[row].isEmpty()) {
+                m_index[calls[row]].append(Slot{award, row});
+            }
+        }
+    }
+}
+
+void AwardEngine::adoptState(const AwardEngine &other)
+{
+    m_awards = other.m_awards;
+    m_index = other.m_index;
+    m_snapshot = other.m_snapshot;
+    ++m_generation;
+}
+
+// Builds the call tables and index of awards read in place from the
+// snapshot, for changes that add or remove rows, and lets the mapping go.
+void AwardEngine::materialize()
+{
+    if (!m_snapshot) {
+        return;
+    }
+    for (Award &a : m_awards) {
+        const int rows = a.ids.size();
+        a.calls.clear();
+        a.calls.reserve(rows);
+        a.rowById.clear();
+        a.rowById.reserve(rows);
+        for (int row = 0; row < rows; ++row) {
+            a.calls.append(QString::fromLatin1(callBytes(a, row)));
+            a.rowById.insert(a.ids[row], row);
+        }
+        a.mapped = MappedCalls();
+    }
+    m_snapshot.reset();
+    m_mappedSlots.clear();
+    rebuildIndex();
+}
+
+QByteArray AwardEngine::callBytes(const Award &a, int row)
+{
+    if (a.mapped.offsets) {
+        const quint32 begin = a.mapped.offsets[row];
+        return QByteArray::fromRawData(a.mapped.strings + begin, int(a.mapped.offsets[row + 1] - begin));
+    }
+    return a.calls[row].toLatin1();
+}
+
+QString AwardEngine::rowCall(int award, int row) const
+{
+    const Award &a = m_awards[award];
+    return a.mapped.offsets ? QString::fromLatin1(callBytes(a, row)) : a.calls[row];
+}
+
+void AwardEngine::adoptTargets(const AwardEngine &other)
+{
+    for (int i = 0; i < m_awards.size() && i < other.m_awards.size(); ++i) {
+        m_awards[i].targets = other.m_awards[i].targets;
+    }
+    m_targetsKnown = other.m_targetsKnown;
+}
+
+int AwardEngine::appendRow(Award &a, qint64 id, const QString &call)
+{
+    const int row = a.ids.size();
+    a.ids.append(id);
+    a.calls.append(call);
+    a.rowById.insert(id, row);
+    a.masks.resize(a.masks.size() + a.def.bands.size());
+    ++m_generation;
+    return row;
+}
+
+// Moves the last row into the hole so no other row changes index.
+void AwardEngine::removeRow(int award, int row)
+{
+    Award &a = m_awards[award];
+    const int bandCount = a.def.bands.size();
+    const int last = a.ids.size() - 1;
+
+    for (int b = 0; b < bandCount; ++b) {
+        setCell(a, row, b, 0);
+    }
+    const auto unindex = [this, award](const QString &call, int r) {
+        const auto it = m_index.find(call);
+        if (it == m_index.end()) {
+            return;
+        }
+        for (int i = 0; i < it->size(); ++i) {
+            if ((*it)[i].award == award && (*it)[i].row == r) {
+                it->remove(i);
+                break;
+            }
+        }
+        if (it->isEmpty()) {
+            m_index.erase(it);
+        }
+    };
+    unindex(a.calls[row], row);
+    a.rowById.remove(a.ids[row]);
+
+    if (row != last) {
+        const QString moved = a.calls[last];
+        unindex(moved, last);
+        a.ids[row] = a.ids[last];
+        a.calls[row] = moved;
+        for (int b = 0; b < bandCount; ++b) {
+            a.masks[row * bandCount + b] = a.masks[last * bandCount + b];
+        }
+        a.rowById.insert(a.ids[row], row);
+        if (!moved.isEmpty()) {
+            m_index[moved].append(Slot{award, row});
+        }
+    }
+
+    a.ids.removeLast();
+    a.calls.removeLast();
+    a.masks.resize(last * bandCount);
+    ++m_generation;
+}
+
+bool AwardEngine::syncTargets(int award, int *added, int *removed, QVector<qint64> *removedIds)
+{
+    Award &a = m_awards[award];
+    if (a.def.targetsFile.isEmpty()) {
+        return true;
+    }
+    if (!m_targetsKnown) {
+        qWarning() << "Target lists not read yet, not syncing" << a.def.name;
+        return false;
+    }
+    materialize();
+
+    QStringList calls;
+    QString error;
+    if (!TargetList::load(a.def.targetsFile, &calls, &error)) {
+        qWarning() << "Cannot read target list" << a.def.targetsFile << "-" << error;
+        return false;
+    }
+    const QSet<QString> next(calls.cbegin(), calls.cend());
+
+    // Whether the award already has a row for `call`, from the index.
+    const auto present = [this, award](const QString &call) {
+        for (const Slot &s : m_index.value(call)) {
+            if (s.award == award) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    QStringList toAdd;
+    for (const QString &call : calls) {
+        if (!a.targets.contains(call) && !present(call)) {
+            toAdd.append(call);
+        }
+    }
+    QStringList toRemove;
+    for (const QString &call : a.targets) {
+        if (!next.contains(call) && present(call)) {
+            toRemove.append(call);
+        }
+    }
+
+    QVector<qint64> ids;
+    if (!TargetList::apply(a.def.table, a.def.bands, toAdd, toRemove, &ids, database())) {
+        return false;
+    }
+    a.targets = next;
+
+    for (const QString &call : toRemove) {
+        // Highest row first: removeRow() moves the last row into the hole,
+        // which must not be one still to be removed.
+        QVector<int> rows;
+        for (const Slot &s : m_index.value(call)) {
+            if (s.award == award) {
+                rows.append(s.row);
+            }
+        }
+        std::sort(rows.begin(), rows.end(), std::greater<int>());
+        for (int row : rows) {
+            if (removedIds) {
+                removedIds->append(a.ids[row]);
+            }
+            removeRow(award, row);
+        }
+    }
+    for (int i = 0; i < toAdd.size(); ++i) {
+        const int row = appendRow(a, ids.value(i), toAdd[i]);
+        m_index[toAdd[i]].append(Slot{award, row});
+    }
+
+    if (added) {
+        *added = toAdd.size();
+    }
+    if (removed) {
+        *removed = toRemove.size();
+    }
+    return true;
+}
+
+int AwardEngine::findAward(const QString &name) const
+{
+    for (int i = 0; i < m_awards.size(); ++i) {
+        if (m_awards[i].def.name.compare(name, Qt::CaseInsensitive) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int AwardEngine::bandIndex(int award, const QString &band) const
+{
+    return m_awards[award].def.bands.indexOf(band);
+}
+
+int AwardEngine::modeBit(int award, const QString &mode) const
+{
+    const QVector<AwardMode> &modes = m_awards[award].def.modes;
+    for (int i = 0; i < modes.size(); ++i) {
+        if (modes[i].name == mode) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+QString AwardEngine::normalizeMode(const QString &mode)
+{
+    const QString m = mode.trimmed().toUpper();
+    if (m == "SSB" || m == "USB" || m == "LSB" || m == "AM" || m == "FM" || m == "PHONE") {
+        return "PH";
+    }
+    return m;
+}
+
+const QVector<AwardEngine::Slot> *AwardEngine::lookup(const QString &call) const
+{
+    if (!m_snapshot) {
+        const auto it = m_index.constFind(call);
+        return it == m_index.constEnd() ? nullptr : &it.value();
+    }
+
+    // Still reading from the snapshot: binary-search each award's call table
+    // where it is mapped.
+    m_mappedSlots.clear();
+    const QByteArray key = call.toLatin1();
+    if (key.isEmpty()) {
+        return nullptr;
+    }
+    for (int award = 0; award < m_awards.size(); ++award) {
+        const Award &a = m_awards[award];
+        const quint32 *first = a.mapped.sorted;
+        const quint32 *last = first + a.ids.size();
+        const quint32 *it = std::lower_bound(first, last, key, [&a](quint32 row, const QByteArray &k) {
+            return callBytes(a, int(row)) < k;
+        });
+        for (; it != last && callBytes(a, int(*it)) == key; ++it) {
+            m_mappedSlots.append(Slot{award, int(*it)});
+        }
+    }
+    return m_mappedSlots.isEmpty() ? nullptr : &m_mappedSlots;
+}
+
+int AwardEngine::mask(int award, int row, int band) const
+{
+    const Award &a = m_awards[award];
+    return a.masks[row * a.def.bands.size() + band];
+}
+
+int AwardEngine::pointGain(const QString &call, const QString &band, const QString &mode) const
+{
+    const QVector<Slot> *slots = lookup(call);
+    return slots ? pointGain(*slots, band, mode) : 0;
+}
+
+int AwardEngine::pointGain(const QVector<Slot> &slots, const QString &band, const QString &mode) const
+{
+    const QString m = normalizeMode(mode);
+    int gain = 0;
+    for (const Slot &s : slots) {
+        const int b = bandIndex(s.award, band);
+        const int bit = modeBit(s.award, m);
+        if (b >= 0 && bit >= 0 && !(mask(s.award, s.row, b) & (1 << bit))) {
+            gain += m_awards[s.award].def.modes[bit].points;
+        }
+    }
+    return gain;
+}
+
+bool AwardEngine::isNeeded(const QString &call, const QString &band, const QString &mode) const
+{
+    const QVector<Slot> *slots = lookup(call);
+    return slots && isNeeded(*slots, band, mode);
+}
+
+bool AwardEngine::isNeeded(const QVector<Slot> &slots, const QString &band, const QString &mode) const
+{
+    const QString m = normalizeMode(mode);
+    for (const Slot &s : slots) {
+        const int b = bandIndex(s.award, band);
+        const int bit = modeBit(s.award, m);
+        if (b >= 0 && bit >= 0 && !(mask(s.award, s.row, b) & (1 << bit))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QVector<int> AwardEngine::applyQso(const QString &call, const QString &band, const QString &mode)
+{
+    QVector<int> changed;
+    const QVector<Slot> *slots = lookup(call);
+    if (!slots) {
+        return changed;
+    }
+
+    const QString m = normalizeMode(mode);
+    const QVector<Slot> targets = *slots;     // setCell() does not touch the index, but be safe
+    for (const Slot &s : targets) {
+        Award &a = m_awards[s.award];
+        const int b = bandIndex(s.award, band);
+        const int bit = modeBit(s.award, m);
+        if (b < 0 || bit < 0) {
+            continue;
+        }
+
+        const int current = mask(s.award, s.row, b);
+        const int updated = current | (1 << bit);
+        if (updated == current) {
+            continue;
+        }
+
+        QSqlQuery u(database());
+        u.prepare(QString(R"(UPDATE %1 SET "%2" = ? WHERE id = ?)").arg(a.def.table, band));
+        u.addBindValue(updated);
+        u.addBindValue(a.ids[s.row]);
+        if (!u.exec()) {
+            qWarning() << "Update failed:" << u.lastError();
+            continue;
+        }
+
+        setCell(a, s.row, b, updated);
+        if (!changed.contains(s.award)) {
+            changed.append(s.award);
+        }
+    }
+    return changed;
+}
+
+void AwardEngine::setMask(int award, qint64 rowId, int band, int mask)
+{
+    Award &a = m_awards[award];
+    int row = -1;
+    if (a.mapped.offsets) {
+        row = a.ids.indexOf(rowId);     // rowById comes with the call tables; a scan does for an edit
+    } else {
+        row = a.rowById.value(rowId, -1);
+    }
+    if (row < 0 || band < 0 || band >= a.def.bands.size()) {
+        return;
+    }
+    setCell(a, row, band, mask);
+}
+
+bool AwardEngine::clear(int award)
+{
+    Award &a = m_awards[award];
+
+    QString sql = QString("UPDATE %1 SET ").arg(a.def.table);
+    for (int b = 0; b < a.def.bands.size(); ++b) {
+        sql += QString(R"(%1"%2" = 0)").arg(QString(b ? ", " : ""), a.def.bands[b]);
+    }
+
+    QSqlQuery q(database());
+    if (!q.exec(sql)) {
+        qWarning() << "Clear failed:" << q.lastError();
+        return false;
+    }
+
+    a.masks.fill(0);
+    a.modeCounts.fill(0);
+    ++m_generation;
+    return true;
+}
+
+AwardEngine::Totals AwardEngine::totals(int award) const
+{
+    const Award &a = m_awards[award];
+    Totals t;
+    t.perMode = a.modeCounts;
+    for (int bit = 0; bit < a.def.modes.size(); ++bit) {
+        t.points += a.modeCounts[bit] * a.def.modes[bit].points;
+    }
+    return t;
+}
+
+void AwardEngine::setCell(Award &a, int row, int band, int mask)
+{
+    quint8 &cell = a.masks[row * a.def.bands.size() + band];
+    const int valid = (1 << a.def.modes.size()) - 1;
+    const int before = cell;
+    const int after = mask & valid;
+    for (int bit = 0; bit < a.def.modes.size(); ++bit) {
+        a.modeCounts[bit] += ((after >> bit) & 1) - ((before >> bit) & 1);
+    }
+    if (after != before) {
+        cell = quint8(after);
+        ++m_generation;
+    }
+}
+
+quint64 AwardEngine::definitionHash(const AwardDefinition &def)
+{
+    QByteArray text = def.name.toUtf8() + '|' + def.table.toUtf8() + '|' + def.bands.join(',').toUtf8();
+    for (const AwardMode &mode : def.modes) {
+        text += '|' + mode.name.toUtf8() + ':' + QByteArray::number(mode.points);
+    }
+    return fnv1a(text);
+}
+
+quint64 AwardEngine::stateChecksum() const
+{
+    quint64 hash = 14695981039346656037ULL;
+    for (const Award &a : m_awards) {
+        hash = fnv1a(reinterpret_cast<const char *>(a.ids.constData()), qint64(a.ids.size()) * 8, hash);
+        for (int row = 0; row < a.ids.size(); ++row) {
+            hash = fnv1a(callBytes(a, row) + '\n', hash);
+        }
+        hash = fnv1a(reinterpret_cast<const char *>(a.masks.constData()), a.masks.size(), hash);
+    }
+    return hash;
+}
+
+QByteArray AwardEngine::snapshotData() const
+{
+    QByteArray payload;
+    for (const Award &a : m_awards) {
+        const int rows = a.ids.size();
+        QVector<QByteArray> calls;
+        calls.reserve(rows);
+        QByteArray strings;
+        QVector<quint32> offsets;
+        offsets.reserve(rows + 1);
+        for (int row = 0; row < rows; ++row) {
+            calls.append(callBytes(a, row));
+            offsets.append(quint32(strings.size()));
+            strings += calls.last();
+        }
+        offsets.append(quint32(strings.size()));
+
+        QVector<quint32> sorted(rows);
+        std::iota(sorted.begin(), sorted.end(), 0u);
+        std::sort(sorted.begin(), sorted.end(), [&calls](quint32 x, quint32 y) {
+            return calls[int(x)] < calls[int(y)];
+        });
+
+        QVector<quint32> counts;
+        for (int count : a.modeCounts) {
+            counts.append(quint32(count));
+        }
+
+        SnapshotAward section{};
+        section.definitionHash = definitionHash(a.def);
+        section.rows = quint32(rows);
+        section.bands = quint32(a.def.bands.size());
+        section.stringBytes = quint32(strings.size());
+        section.modes = quint32(a.def.modes.size());
+
+        appendPadded(payload, &section, sizeof(section));
+        appendPadded(payload, a.ids.constData(), qint64(rows) * qint64(sizeof(qint64)));
+        appendPadded(payload, offsets.constData(), qint64(offsets.size()) * qint64(sizeof(quint32)));
+        appendPadded(payload, strings.constData(), strings.size());
+        appendPadded(payload, sorted.constData(), qint64(rows) * qint64(sizeof(quint32)));
+        appendPadded(payload, a.masks.constData(), a.masks.size());
+        appendPadded(payload, counts.constData(), qint64(counts.size()) * qint64(sizeof(quint32)));
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kSnapshotVersion;
+    header.awardCount = quint32(m_awards.size());
+    header.payloadSize = quint64(payload.size());
+    header.checksum = fnv1a(payload);
+
+    QByteArray data(reinterpret_cast<const char *>(&header), int(sizeof(header)));
+    data += payload;
+    return data;
+}
+
+bool AwardEngine::writeSnapshot(const QString &path, const QByteArray &data)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write snapshot" << path << "-" << file.errorString();
+        return false;
+    }
+    file.write(data);
+    if (!file.commit()) {
+        qWarning() << "Cannot write snapshot" << path << "-" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool AwardEngine::saveSnapshot(const QString &path) const
+{
+    // A mapped file cannot be replaced on Windows. Until the reconcile has
+    // built the call tables the snapshot in use stays; SQLite has every
+    // change, so the next start reconciles as usual.
+    if (m_snapshot && m_snapshot->fileName() == path) {
+        qDebug() << "Snapshot" << path << "still mapped, not rewriting it";
+        return false;
+    }
+    return writeSnapshot(path, snapshotData());
+}
+
+bool AwardEngine::loadSnapshot(const QString &path)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    auto file = QSharedPointer<QFile>::create(path);
+    if (!file->open(QIODevice::ReadOnly) || file->size() < qint64(sizeof(SnapshotHeader))) {
+        return false;
+    }
+
+    const uchar *base = file->map(0, file->size());
+    if (!base) {
+        return false;
+    }
+    const char *data = reinterpret_cast<const char *>(base);
+
+    SnapshotHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0
+        || header.version != kSnapshotVersion
+        || header.awardCount != quint32(m_awards.size())
+        || header.payloadSize != quint64(file->size()) - sizeof(header)) {
+        qDebug() << "Snapshot" << path << "does not match, loading from database";
+        return false;
+    }
+
+    const char *payload = data + sizeof(header);
+    const char *end = payload + header.payloadSize;
+    if (fnv1a(payload, qint64(header.payloadSize)) != header.checksum) {
+        qWarning() << "Snapshot" << path << "checksum mismatch, loading from database";
+        return false;
+    }
+
+    auto padded = [](quint64 n) { return (n + 7) & ~quint64(7); };
+
+    // Parse into fresh awards so a bad section leaves the engine untouched.
+    // Ids, masks and counts are plain copies; the callsigns and their sorted
+    // order are used where they are in the mapping. Every section is padded
+    // to 8 bytes, so the arrays are aligned.
+    QVector<Award> loaded = m_awards;
+    const char *p = payload;
+    for (Award &a : loaded) {
+        SnapshotAward section;
+        if (end - p < qint64(sizeof(section))) {
+            return false;
+        }
+        std::memcpy(&section, p, sizeof(section));
+        p += padded(sizeof(section));
+
+        if (section.definitionHash != definitionHash(a.def)
+            || section.bands != quint32(a.def.bands.size())
+            || section.modes != quint32(a.def.modes.size())) {
+            qDebug() << "Snapshot" << path << "was written for other award definitions";
+            return false;
+        }
+
+        const quint64 rows = section.rows;
+        const quint64 idBytes = padded(rows * sizeof(qint64));
+        const quint64 offsetBytes = padded((rows + 1) * sizeof(quint32));
+        const quint64 stringBytes = padded(section.stringBytes);
+        const quint64 sortedBytes = padded(rows * sizeof(quint32));
+        const quint64 maskBytes = padded(rows * section.bands);
+        const quint64 countBytes = padded(section.modes * sizeof(quint32));
+        if (quint64(end - p) < idBytes + offsetBytes + stringBytes + sortedBytes + maskBytes + countBytes) {
+            return false;
+        }
+
+        const char *ids = p;
+        const auto *offsets = reinterpret_cast<const quint32 *>(ids + idBytes);
+        const char *strings = ids + idBytes + offsetBytes;
+        const auto *sorted = reinterpret_cast<const quint32 *>(strings + stringBytes);
+        const char *masks = strings + stringBytes + sortedBytes;
+        const auto *counts = reinterpret_cast<const quint32 *>(masks + maskBytes);
+        p = masks + maskBytes + countBytes;
+
+        // The checksum vouches for the content; this only keeps a broken
+        // writer from sending lookups out of bounds.
+        if (offsets[0] != 0 || offsets[rows] > section.stringBytes) {
+            return false;
+        }
+        for (quint64 row = 0; row < rows; ++row) {
+            if (offsets[row + 1] < offsets[row] || sorted[row] >= rows) {
+                return false;
+            }
+        }
+
+        a.ids.resize(int(rows));
+        std::memcpy(a.ids.data(), ids, rows * sizeof(qint64));
+        a.masks.resize(int(rows * section.bands));
+        std::memcpy(a.masks.data(), masks, rows * section.bands);
+        a.modeCounts.resize(int(section.modes));
+        for (quint32 bit = 0; bit < section.modes; ++bit) {
+            a.modeCounts[int(bit)] = int(counts[bit]);
+        }
+        a.calls.clear();
+        a.rowById.clear();
+        a.mapped = MappedCalls{offsets, strings, sorted};
+    }
+
+    m_awards = loaded;
+    m_index.clear();
+    m_snapshot = file;
+    ++m_generation;
+    qDebug() << "Snapshot mapped in" << timer.elapsed() << "ms";
+    return true;
+}
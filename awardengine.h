@@ -0,0 +1,184 @@
+#ifndef AWARDENGINE_H
+#define AWARDENGINE_H
+
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <QSharedPointer>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+struct AwardMode {
+    QString name;       // "CW", "PH", "FT8", ...
+    int points = 0;
+};
+
+// One award or event: its target list and what counts towards it.
+// Each award is stored in its own SQLite table with one column per band;
+// a cell holds a bit mask of worked modes (bit i = modes[i]).
+struct AwardDefinition {
+    QString name;
+    QString table;
+    QString targetsFile;
+    QStringList bands;
+    QVector<AwardMode> modes;   // at most 8
+};
+
+// Award state for every active award, kept in memory and written through
+// to SQLite.
+//
+// All awards share one callsign index, so a spot or QSO is matched against
+// every award with a single hash lookup.
+class AwardEngine
+{
+public:
+    struct Slot {
+        int award;
+        int row;
+    };
+
+    struct Totals {
+        QVector<int> perMode;   // worked band slots per mode
+        int points = 0;
+    };
+
+    // WWA: 8 bands, CW=10, PH=5, FT8=2, FT4=2, table "modes".
+    static AwardDefinition defaultWwa();
+
+    // Reads award definitions from a JSON file. A missing file gives the
+    // default WWA award alone.
+    bool loadDefinitions(const QString &path, QString *error = nullptr);
+
+    // Database connection used for every query; the default connection
+    // unless set. A copy of the engine working on another thread needs a
+    // connection of its own.
+    void setConnectionName(const QString &name) { m_connection = name; }
+
+    // Takes over the award rows, cells and index of `other` (e.g. a copy
+    // reloaded on a worker thread), keeping this engine's connection.
+    void adoptState(const AwardEngine &other);
+
+    // Takes over the target lists `other` read in setupTables().
+    void adoptTargets(const AwardEngine &other);
+
+    // False after a snapshot start until setupTables() or adoptTargets():
+    // the snapshot holds the rows, not the target lists they came from, and
+    // syncTargets() needs those to know which calls were dropped.
+    bool targetsKnown() const { return m_targetsKnown; }
+
+    // Creates or extends each award's table and seeds it from its target list.
+    bool setupTables();
+
+    // Reads every award table into memory and rebuilds the callsign index.
+    bool loadState();
+    bool reloadAward(int award);
+
+    // Re-reads an award's target list and applies only the difference from
+    // the list as last read: new calls get rows, dropped calls lose theirs,
+    // in one transaction. The index is updated in place; rows added by hand
+    // are left alone. The row ids of removed rows go to `removedIds`.
+    // Returns false on a read or database error.
+    bool syncTargets(int award, int *added = nullptr, int *removed = nullptr,
+                     QVector<qint64> *removedIds = nullptr);
+
+    int awardCount() const { return m_awards.size(); }
+    const AwardDefinition &award(int award) const { return m_awards[award].def; }
+    int findAward(const QString &name) const;
+    void setTargetsFile(int award, const QString &path) { m_awards[award].def.targetsFile = path; }
+
+    int bandIndex(int award, const QString &band) const;
+    int modeBit(int award, const QString &mode) const;
+
+    // "SSB", "USB", "LSB", "AM", "FM" -> "PH"; otherwise upper-cased.
+    static QString normalizeMode(const QString &mode);
+
+    // Every award row for `call`, or nullptr if it is not a target anywhere.
+    // The result stays valid until the next lookup or change to the engine.
+    const QVector<Slot> *lookup(const QString &call) const;
+
+    int rowCount(int award) const { return m_awards[award].ids.size(); }
+    QString rowCall(int award, int row) const;
+    int mask(int award, int row, int band) const;
+
+    // Points a QSO with `call` on band/mode would add over all awards.
+    int pointGain(const QString &call, const QString &band, const QString &mode) const;
+    // True if at least one award has `call` and has not worked it on band/mode.
+    bool isNeeded(const QString &call, const QString &band, const QString &mode) const;
+    // The same for rows already found with lookup(), so a spot costs one
+    // hash lookup however many questions are asked about it.
+    int pointGain(const QVector<Slot> &slots, const QString &band, const QString &mode) const;
+    bool isNeeded(const QVector<Slot> &slots, const QString &band, const QString &mode) const;
+
+    // Sets the band/mode bit for `call` in every award that wants it and
+    // writes the changed cells to the database. Returns the changed awards.
+    QVector<int> applyQso(const QString &call, const QString &band, const QString &mode);
+
+    // Mirrors a cell already written to the database (e.g. by the table view).
+    void setMask(int award, qint64 rowId, int band, int mask);
+
+    // Sets every cell of an award to zero, in memory and in the database.
+    bool clear(int award);
+
+    Totals totals(int award) const;
+
+    // Binary snapshot of the in-memory state (row ids, callsigns, masks,
+    // per-mode counts and each award's rows in callsign order) for fast
+    // startup. The file is versioned and checksummed and is only used when
+    // it matches the current award definitions; SQLite stays the source of
+    // truth. loadSnapshot() copies the ids, masks and counts but leaves the
+    // callsigns in the mapped file: lookup() binary-searches the sorted call
+    // table there until loadState(), adoptState() or a change to the rows
+    // builds the in-memory call tables and index.
+    bool saveSnapshot(const QString &path) const;
+    bool loadSnapshot(const QString &path);
+
+    // saveSnapshot() in two steps, so that the encoding can run on a worker.
+    QByteArray snapshotData() const;
+    static bool writeSnapshot(const QString &path, const QByteArray &data);
+
+    // Hash over every award's rows, to tell whether a reload changed anything.
+    quint64 stateChecksum() const;
+
+    // Bumped by every change to rows or cells; cheap to poll for publishing.
+    quint64 generation() const { return m_generation; }
+
+private:
+    // Callsigns of an award still read in place from the snapshot.
+    struct MappedCalls {
+        const quint32 *offsets = nullptr;   // rows + 1, into strings
+        const char *strings = nullptr;
+        const quint32 *sorted = nullptr;    // rows in callsign order
+    };
+
+    struct Award {
+        AwardDefinition def;
+        QVector<qint64> ids;            // SQLite row id per row
+        QStringList calls;              // empty while mapped
+        QVector<quint8> masks;          // rows x bands
+        QHash<qint64, int> rowById;     // empty while mapped
+        QVector<int> modeCounts;        // worked cells per mode bit
+        QSet<QString> targets;          // target list as last read from targetsFile
+        MappedCalls mapped;
+    };
+
+    QSqlDatabase database() const { return QSqlDatabase::database(m_connection); }
+    void setCell(Award &a, int row, int band, int mask);
+    void rebuildIndex();
+    int appendRow(Award &a, qint64 id, const QString &call);
+    void removeRow(int award, int row);
+    void materialize();
+    static QByteArray callBytes(const Award &a, int row);
+    static quint64 definitionHash(const AwardDefinition &def);
+
+    QVector<Award> m_awards;
+    QHash<QString, QVector<Slot>> m_index;     // empty while mapped
+    QSharedPointer<QFile> m_snapshot;           // set while calls are read from its mapping
+    mutable QVector<Slot> m_mappedSlots;        // lookup() result while mapped
+    quint64 m_generation = 0;
+    bool m_targetsKnown = false;
+    QString m_connection = QLatin1String(QSqlDatabase::defaultConnection);
+};
+
+#endif // AWARDENGINE_H
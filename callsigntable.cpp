@@ -0,0 +1,61 @@
+#include "callsigntable.h"
+
+#include <QDebug>
+
+bool CallsignTable::open(const QString &path)
+{
+    m_keys.clear();
+    m_names.clear();
+    m_file.close();
+    m_file.setFileName(path);
+
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Append)) {
+        qWarning() << "Cannot open callsign table" << path << "-" << m_file.errorString();
+        return false;
+    }
+
+    m_file.seek(0);
+    while (!m_file.atEnd()) {
+        const QString call = QString::fromLatin1(m_file.readLine().trimmed());
+        // Keep empty lines so that keys stay aligned with line numbers.
+        m_names.append(call);
+        if (!call.isEmpty()) {
+            m_keys.insert(call, quint32(m_names.size()));
+        }
+    }
+    return true;
+}
+
+quint32 CallsignTable::key(const QString &call, bool create)
+{
+    if (call.isEmpty()) {
+        return 0;
+    }
+
+    const auto it = m_keys.constFind(call);
+    if (it != m_keys.constEnd()) {
+        return it.value();
+    }
+    if (!create) {
+        return 0;
+    }
+
+    m_names.append(call);
+    const quint32 k = quint32(m_names.size());
+    m_keys.insert(call, k);
+
+    if (m_file.isOpen()) {
+        m_file.write(call.toLatin1());
+        m_file.write("\n", 1);
+        m_file.flush();
+    }
+    return k;
+}
+
+QString CallsignTable::name(quint32 key) const
+{
+    if (key == 0 || key > quint32(m_names.size())) {
+        return QString();
+    }
+    return m_names.at(int(key - 1));
+}
@@ -0,0 +1,34 @@
+#ifndef CALLSIGNTABLE_H
+#define CALLSIGNTABLE_H
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+// Interns callsigns as small integer keys (1, 2, 3, ...; 0 means "none").
+//
+// The table is append-only and persisted as a text file with one callsign
+// per line, so key N is line N and keys stay stable across runs. Records in
+// SpotHistory refer to callsigns and skimmers through these keys.
+class CallsignTable
+{
+public:
+    CallsignTable() = default;
+
+    bool open(const QString &path);
+
+    // Returns the key for `call`, adding it when `create` is true.
+    // Returns 0 for an empty call or an unknown call with create == false.
+    quint32 key(const QString &call, bool create = true);
+
+    QString name(quint32 key) const;
+    int size() const { return int(m_names.size()); }
+
+private:
+    QFile m_file;
+    QHash<QString, quint32> m_keys;
+    QStringList m_names;            // m_names[key - 1]
+};
+
+#endif // CALLSIGNTABLE_H
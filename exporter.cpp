@@ -0,0 +1,248 @@
+#include "exporter.h"
+#include "awardengine.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QTextStream>
+#include <QDebug>
+#include <cstdio>
+
+namespace {
+
+QString modeList(const AwardDefinition &award, int mask, const QString &separator)
+{
+    QString out;
+    for (int bit = 0; bit < award.modes.size(); ++bit) {
+        if (!(mask & (1 << bit))) {
+            continue;
+        }
+        if (!out.isEmpty()) {
+            out += separator;
+        }
+        out += award.modes[bit].name;
+    }
+    return out;
+}
+
+QString csvField(const QString &value)
+{
+    if (!value.contains(QLatin1Char(',')) && !value.contains(QLatin1Char('"'))
+        && !value.contains(QLatin1Char('\n'))) {
+        return value;
+    }
+    QString quoted = value;
+    quoted.replace(QLatin1Char('"'), QLatin1String("\"\""));
+    return QLatin1Char('"') + quoted + QLatin1Char('"');
+}
+
+QString jsonString(const QString &value)
+{
+    QString out;
+    out.reserve(value.size() + 2);
+    out += QLatin1Char('"');
+    for (const QChar ch : value) {
+        switch (ch.unicode()) {
+        case '"':  out += QLatin1String("\\\""); break;
+        case '\\': out += QLatin1String("\\\\"); break;
+        case '\n': out += QLatin1String("\\n"); break;
+        case '\r': out += QLatin1String("\\r"); break;
+        case '\t': out += QLatin1String("\\t"); break;
+        default:
+            if (ch.unicode() < 0x20) {
+                out += QString("\\u%1").arg(ch.unicode(), 4, 16, QLatin1Char('0'));
+            } else {
+                out += ch;
+            }
+        }
+    }
+    out += QLatin1Char('"');
+    return out;
+}
+
+void adifField(QTextStream &ts, const char *name, const QString &value)
+{
+    ts << '<' << name << ':' << value.toUtf8().size() << '>' << value << ' ';
+}
+
+void writeAdifRecord(QTextStream &ts, const QString &call, const QString &band, const QString &mode)
+{
+    adifField(ts, "CALL", call);
+    bool numeric = false;
+    band.toDouble(&numeric);
+    adifField(ts, "BAND", numeric ? band + QLatin1Char('m') : band);
+    if (mode == "PH") {
+        adifField(ts, "MODE", "SSB");
+    } else if (mode == "FT4") {
+        adifField(ts, "MODE", "MFSK");
+        adifField(ts, "SUBMODE", "FT4");
+    } else {
+        adifField(ts, "MODE", mode);
+    }
+    ts << "<EOR>\n";
+}
+
+} // namespace
+
+namespace Exporter {
+
+bool formatFromName(const QString &name, Format *format)
+{
+    const QString n = name.trimmed().toLower();
+    if (n == "csv") {
+        *format = Format::Csv;
+    } else if (n == "json") {
+        *format = Format::Json;
+    } else if (n == "adi" || n == "adif") {
+        *format = Format::Adif;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool formatFromPath(const QString &path, Format *format)
+{
+    return formatFromName(QFileInfo(path).suffix(), format);
+}
+
+bool exportAward(const AwardDefinition &award, Format format, QIODevice *out, QString *error)
+{
+    const QStringList &bands = award.bands;
+
+    QString sql = "SELECT callsign";
+    for (const QString &band : bands) {
+        sql += QString(R"(, "%1")").arg(band);
+    }
+    sql += QString(" FROM %1 ORDER BY callsign").arg(award.table);
+
+    QSqlQuery q;
+    q.setForwardOnly(true);     // no client-side row cache
+    if (!q.exec(sql)) {
+        qWarning() << "Export query failed:" << q.lastError();
+        if (error) {
+            *error = q.lastError().text();
+        }
+        return false;
+    }
+
+    QTextStream ts(out);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    ts.setCodec("UTF-8");
+#endif
+
+    switch (format) {
+    case Format::Csv:
+        ts << "callsign";
+        for (const QString &band : bands) {
+            ts << ',' << band;
+        }
+        ts << '\n';
+        break;
+    case Format::Json:
+        ts << "[\n";
+        break;
+    case Format::Adif:
+        ts << award.name << " worked-station export\n";
+        adifField(ts, "ADIF_VER", "3.1.4");
+        adifField(ts, "PROGRAMID", "WWA");
+        ts << "<EOH>\n";
+        break;
+    }
+
+    bool first = true;
+    while (q.next()) {
+        const QString call = q.value(0).toString().trimmed().toUpper();
+        if (call.isEmpty()) {
+            continue;
+        }
+
+        switch (format) {
+        case Format::Csv:
+            ts << csvField(call);
+            for (int i = 0; i < bands.size(); ++i) {
+                ts << ',' << modeList(award, q.value(i + 1).toInt(), " ");
+            }
+            ts << '\n';
+            break;
+        case Format::Json:
+            ts << (first ? "  " : ",\n  ") << "{\"callsign\": " << jsonString(call) << ", \"bands\": {";
+            for (int i = 0; i < bands.size(); ++i) {
+                const int mask = q.value(i + 1).toInt();
+                ts << (i ? ", " : "") << jsonString(bands[i]) << ": [";
+                bool firstMode = true;
+                for (int bit = 0; bit < award.modes.size(); ++bit) {
+                    if (mask & (1 << bit)) {
+                        ts << (firstMode ? "" : ", ") << jsonString(award.modes[bit].name);
+                        firstMode = false;
+                    }
+                }
+                ts << ']';
+            }
+            ts << "}}";
+            break;
+        case Format::Adif:
+            for (int i = 0; i < bands.size(); ++i) {
+                const int mask = q.value(i + 1).toInt();
+                for (int bit = 0; bit < award.modes.size(); ++bit) {
+                    if (mask & (1 << bit)) {
+                        writeAdifRecord(ts, call, bands[i], award.modes[bit].name);
+                    }
+                }
+            }
+            break;
+        }
+        first = false;
+    }
+
+    if (format == Format::Json) {
+        ts << (first ? "]\n" : "\n]\n");
+    }
+
+    ts.flush();
+    if (ts.status() != QTextStream::Ok) {
+        if (error) {
+            *error = out->errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+bool exportAwardToFile(const AwardDefinition &award, Format format, const QString &path, QString *error)
+{
+    if (path.isEmpty() || path == "-") {
+        QFile out;
+        if (!out.open(stdout, QIODevice::WriteOnly)) {
+            if (error) {
+                *error = out.errorString();
+            }
+            return false;
+        }
+        return exportAward(award, format, &out, error);
+    }
+
+    QSaveFile out(path);
+    if (!out.open(QIODevice::WriteOnly)) {
+        if (error) {
+            *error = out.errorString();
+        }
+        return false;
+    }
+    if (!exportAward(award, format, &out, error)) {
+        out.cancelWriting();
+        return false;
+    }
+    if (!out.commit()) {
+        if (error) {
+            *error = out.errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+} // namespace Exporter
@@ -0,0 +1,37 @@
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+#include <QString>
+
+class QIODevice;
+struct AwardDefinition;
+
+// Streaming export of an award table.
+//
+// Rows are read with a forward-only query and written through a buffered
+// QTextStream, one row at a time, so memory use does not depend on the
+// number of target stations.
+namespace Exporter {
+
+enum class Format {
+    Csv,    // award state: one row per callsign, one column per band
+    Json,   // award state: array of { callsign, bands: { "20": ["CW"] } }
+    Adif    // worked-station list: one record per worked band/mode slot
+};
+
+// Accepts "csv", "json", "adi" and "adif" (case-insensitive).
+bool formatFromName(const QString &name, Format *format);
+
+// Picks the format from a file suffix, e.g. "progress.adi".
+bool formatFromPath(const QString &path, Format *format);
+
+bool exportAward(const AwardDefinition &award, Format format, QIODevice *out, QString *error = nullptr);
+
+// Writes to a temporary file and renames it over `path` on success.
+// An empty path or "-" writes to stdout.
+bool exportAwardToFile(const AwardDefinition &award, Format format, const QString &path,
+                       QString *error = nullptr);
+
+} // namespace Exporter
+
+#endif // EXPORTER_H
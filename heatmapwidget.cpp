@@ -0,0 +1,75 @@
+#include "heatmapwidget.h"
+
+#include <QPainter>
+#include <algorithm>
+
+namespace {
+constexpr int kLabelWidth = 40;
+constexpr int kHeaderHeight = 16;
+constexpr int kRowHeight = 14;
+}
+
+HeatMapWidget::HeatMapWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+}
+
+QSize HeatMapWidget::sizeHint() const
+{
+    return QSize(kLabelWidth + ActivityStats::kHours * 24,
+                 kHeaderHeight + int(m_bands.size()) * kRowHeight + 2);
+}
+
+void HeatMapWidget::setBands(const QVector<int> &bands)
+{
+    m_bands = bands;
+    m_counts.fill(0, m_bands.size() * ActivityStats::kHours);
+    m_max = 0;
+    updateGeometry();
+    update();
+}
+
+void HeatMapWidget::setCounts(const QString &call, const ActivityStats::Counts *counts)
+{
+    m_call = call;
+    if (counts && counts->size() == m_bands.size() * ActivityStats::kHours) {
+        m_counts = *counts;
+    } else {
+        m_counts.fill(0, m_bands.size() * ActivityStats::kHours);
+    }
+    m_max = m_counts.isEmpty() ? 0 : *std::max_element(m_counts.cbegin(), m_counts.cend());
+    setToolTip(m_call.isEmpty() ? QString() : QString("%1: spots per band and UTC hour").arg(m_call));
+    update();
+}
+
+void HeatMapWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    const int cellWidth = qMax(1, (width() - kLabelWidth) / ActivityStats::kHours);
+
+    painter.setPen(palette().color(QPalette::WindowText));
+    for (int h = 0; h < ActivityStats::kHours; h += 2) {
+        const QRect r(kLabelWidth + h * cellWidth, 0, cellWidth * 2, kHeaderHeight);
+        painter.drawText(r, Qt::AlignLeft | Qt::AlignVCenter, QString("%1").arg(h, 2, 10, QLatin1Char('0')));
+    }
+
+    for (int row = 0; row < m_bands.size(); ++row) {
+        const int y = kHeaderHeight + row * kRowHeight;
+        painter.setPen(palette().color(QPalette::WindowText));
+        painter.drawText(QRect(0, y, kLabelWidth - 4, kRowHeight),
+                         Qt::AlignRight | Qt::AlignVCenter, QString("%1m").arg(m_bands[row]));
+
+        for (int h = 0; h < ActivityStats::kHours; ++h) {
+            const quint32 n = m_counts[row * ActivityStats::kHours + h];
+            const QRect cell(kLabelWidth + h * cellWidth, y, cellWidth - 1, kRowHeight - 1);
+            if (n == 0 || m_max == 0) {
+                painter.fillRect(cell, QColor("#f0f0f0"));
+                continue;
+            }
+            // Light blue for a single spot up to saturated red at the maximum.
+            const double t = double(n) / double(m_max);
+            painter.fillRect(cell, QColor::fromHsvF(0.6 * (1.0 - t), 0.25 + 0.75 * t, 1.0));
+        }
+    }
+}
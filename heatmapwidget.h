@@ -0,0 +1,31 @@
+#ifndef HEATMAPWIDGET_H
+#define HEATMAPWIDGET_H
+
+#include "activitystats.h"
+
+#include <QWidget>
+
+// Band x UTC hour grid for one station, shaded by spot count.
+class HeatMapWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit HeatMapWidget(QWidget *parent = nullptr);
+
+    // Band rows in meters, as in ActivityStats::bands().
+    void setBands(const QVector<int> &bands);
+    void setCounts(const QString &call, const ActivityStats::Counts *counts);
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    QString m_call;
+    QVector<int> m_bands;
+    ActivityStats::Counts m_counts;
+    quint32 m_max = 0;
+};
+
+#endif // HEATMAPWIDGET_H
@@ -1,6 +1,13 @@
 #include "mainwindow.h"
+#include "exporter.h"
+#include "awardengine.h"
 
 #include <QApplication>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <cstring>
 #include <QTableView>
 #include <QSqlDatabase>
 #include <QSqlTableModel>
@@ -11,78 +18,190 @@
 #include <QMouseEvent>
 #include <QDebug>
 
-bool setupDatabase() {
+// Opens WWA.db and loads the award definitions without reading or writing
+// any award table. The export path opens the database read-only.
+static bool openDatabase(AwardEngine &awards, const AppConfig &config, bool readOnly = false)
+{
     QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
     db.setDatabaseName("WWA.db");
+    if (readOnly) {
+        db.setConnectOptions("QSQLITE_OPEN_READONLY");
+    }
 
     if (!db.open()) {
         qFatal("Cannot open database!");
         return false;
     }
 
-    QSqlQuery query;
-
-    // ✅ Create the table
-    if (!query.exec(R"(
-        CREATE TABLE IF NOT EXISTS modes (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            callsign TEXT,
-            "10" INTEGER,
-            "12" INTEGER,
-            "15" INTEGER,
-            "17" INTEGER,
-            "20" INTEGER,
-            "30" INTEGER,
-            "40" INTEGER,
-            "80" INTEGER
-        )
-    )")) {
-        qWarning() << "Failed to create table:" << query.lastError();
+    QString error;
+    if (!awards.loadDefinitions(config.awardsFile, &error)) {
+        qWarning() << "Cannot load award definitions" << config.awardsFile << "-" << error;
         return false;
     }
 
+    // --targets replaces the target list of the first award.
+    if (!config.targetsFile.isEmpty()) {
+        awards.setTargetsFile(0, config.targetsFile);
+    }
+    return true;
+}
 
-    // ✅ Only insert if table is empty
-    if (!query.exec("SELECT COUNT(*) FROM modes")) {
-        qWarning() << "Failed to count rows:" << query.lastError();
+// With `fromSnapshot` set, award state is taken from the snapshot file when
+// it is valid and the database is only opened; the caller reconciles later.
+bool setupDatabase(AwardEngine &awards, const AppConfig &config, bool *fromSnapshot = nullptr) {
+    if (!openDatabase(awards, config)) {
         return false;
     }
 
-    if (query.next() && query.value(0).toInt() == 0) {
-        QStringList calls = {
-            "3B8WWA","3Z6I","4M5A","4M5DX","4U1A","8A1A","9M2WWA","9M8WWA","A43WWA","AT2WWA","AT3WWA","AT4WWA","AT6WWA","AT7WWA","BA3RA","BA7CK","BG0DXC","BH9CA","BI4SSB","BY1RX",
-            "BY2WL","BY5HB","BY6SX","BY8MA","CQ7WWA","CR2WWA","CR5WWA","CR6WWA","D4W","DA0WWA","DL0WWA","DU0WWA","E2WWA","E7W","EG1WWA","EG2WWA","EG3WWA","EG4WWA","EG5WWA","EG6WWA",
-            "EG7WWA","EG9WWA","EM0WWA","GB0WWA","GB1WWA","GB2WWA","GB4WWA","GB5WWA","GB6WWA","GB8WWA","GB9WWA","HB9WWA","HI3WWA","HI6WWA","HI7WWA","HI8WWA","HZ1WWA","II0WWA","II1WWA",
-            "II2WWA","II3WWA","II4WWA","II5WWA","II6WWA","II7WWA","II8WWA","II9WWA","IR0WWA","IR1WWA","LR1WWA","N0W","N1W","N4W","N6W","N8W","N9W","OL6WWA","OP0WWA","PA26WWA","PC26WWA",
-            "PD26WWA","PE26WWA","PF26WWA","RW1F","S53WWA","SB9WWA","SC9WWA","SD9WWA","SN0WWA","SN1WWA","SN2WWA","SN3WWA","SN4WWA","SN6WWA","SO3WWA","SX0W","TK4TH","TM18WWA","TM1WWA",
-            "TM29WWA","TM7WWA","TM9WWA","UP7WWA","VB2WWA","VC1WWA","VE9WWA","W4I","YI1RN","YL73R","YO0WWA","YU45MJA","Z30WWA"
-        };
-        for (const QString &call : calls) {
-            query.prepare(R"(
-                INSERT INTO modes (callsign, "10", "12", "15", "17", "20", "30", "40", "80")
-                VALUES (?, 0, 0, 0, 0, 0, 0, 0, 0)
-            )");
-            query.addBindValue(call);
-            if (!query.exec()) {
-                qWarning() << "Insert failed for call:" << call; // << query.lastError();
-            }
+    if (fromSnapshot) {
+        *fromSnapshot = awards.loadSnapshot(config.snapshotFile);
+        if (*fromSnapshot) {
+            return true;
         }
+    }
 
-        qDebug() << "Inserted" << calls.size() << "calls";
-    } else {
-        qDebug() << "Data already exists, skipping insert.";
+    if (!awards.setupTables() || !awards.loadState()) {
+        return false;
+    }
+    if (fromSnapshot) {
+        awards.saveSnapshot(config.snapshotFile);
     }
     return true;
 }
 
+static bool isHeadless(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--export") == 0 || std::strncmp(argv[i], "--export=", 9) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Cold start on an existing database should stay below this.
+static constexpr qint64 kStartupBudgetMs = 250;
+
+static void setupParser(QCommandLineParser &parser)
+{
+    parser.setApplicationDescription("WWA award tracker");
+    parser.addHelpOption();
+    parser.addOption({"export", "Export award state without opening a window (csv, json, adif).", "format"});
+    parser.addOption({{"o", "output"}, "Export destination; stdout if omitted.", "file"});
+    parser.addOption({"award", "Award to export (default: the first one).", "name"});
+    parser.addOption({"awards", "Award definitions (default: awards.json; WWA only if missing).", "file"});
+    parser.addOption({"targets", "Target station list of the first award.", "file"});
+    parser.addOption({"udp", "WSJT-X/JTDX, N1MM+ or ADIF UDP endpoint host:port, "
+                             "may be repeated; multicast groups are joined (default: 127.0.0.1:2333).", "endpoint"});
+    parser.addOption({"rbn", "RBN telnet server host:port (default: telnet.reversebeacon.net:7000).", "endpoint"});
+    parser.addOption({"rbn-call", "Callsign sent at the RBN login prompt (default: OG3Z).", "call"});
+    parser.addOption({"no-share", "Do not publish award state to WWA.state or answer queries on wwa-state."});
+    parser.addOption({"auto-reply", "Start with auto-reply on: answer CQs from needed stations via WSJT-X."});
+    parser.addOption({"measure-latency", "Log ingest rates and decode-to-handler latency every 10 s "
+                                         "(decode times must be send times, as from wwa-loadgen)."});
+}
+
+static AppConfig configFromParser(const QCommandLineParser &parser)
+{
+    AppConfig config;
+    if (parser.isSet("awards")) {
+        config.awardsFile = parser.value("awards");
+    }
+    config.targetsFile = parser.value("targets");
+    if (parser.isSet("udp")) {
+        config.udpEndpoints = parser.values("udp");
+    }
+    if (parser.isSet("rbn")) {
+        config.rbnEndpoint = parser.value("rbn");
+    }
+    if (parser.isSet("rbn-call")) {
+        config.rbnCall = parser.value("rbn-call").trimmed().toUpper();
+    }
+    if (parser.isSet("no-share")) {
+        config.sharedStateFile.clear();
+        config.stateSocket.clear();
+    }
+    config.autoReply = parser.isSet("auto-reply");
+    config.measureLatency = parser.isSet("measure-latency");
+    return config;
+}
+
+// Headless invocation: WWA --export csv|json|adif [--award name] [--output file]
+static int runHeadless(QCoreApplication &app)
+{
+    QCommandLineParser parser;
+    setupParser(parser);
+    parser.process(app);
+
+    Exporter::Format format;
+    if (!Exporter::formatFromName(parser.value("export"), &format)) {
+        qWarning() << "Unknown export format:" << parser.value("export");
+        return 2;
+    }
+
+    // Only the definitions are needed; the export streams each table from a
+    // forward-only cursor and must not load or change award state.
+    AwardEngine awards;
+    if (!openDatabase(awards, configFromParser(parser), true))
+        return -1;
+
+    int award = 0;
+    if (parser.isSet("award")) {
+        award = awards.findAward(parser.value("award"));
+        if (award < 0) {
+            qWarning() << "Unknown award:" << parser.value("award");
+            return 2;
+        }
+    }
+
+    QString error;
+    if (!Exporter::exportAwardToFile(awards.award(award), format, parser.value("output"), &error)) {
+        qWarning() << "Export failed:" << error;
+        return 1;
+    }
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
+    QElapsedTimer startup;
+    startup.start();
+
+    if (isHeadless(argc, argv)) {
+        QCoreApplication app(argc, argv);
+        return runHeadless(app);
+    }
+
     QApplication app(argc, argv);
+    QCommandLineParser parser;
+    setupParser(parser);
+    parser.process(app);
+
+    const AppConfig config = configFromParser(parser);
 
-    if (!setupDatabase())
+    AwardEngine awards;
+    bool fromSnapshot = false;
+    if (!setupDatabase(awards, config, &fromSnapshot))
         return -1;
-    MainWindow window;
+    const qint64 dbMs = startup.elapsed();
+
+    MainWindow window(config, &awards);
     window.show();
 
+    // Runs once the first event loop pass has painted the window.
+    QTimer::singleShot(0, &app, [&startup, dbMs]() {
+        const qint64 totalMs = startup.elapsed();
+        qDebug() << "Startup:" << totalMs << "ms (award state" << dbMs << "ms)";
+        if (totalMs > kStartupBudgetMs) {
+            qWarning() << "Startup exceeded budget of" << kStartupBudgetMs << "ms";
+        }
+    });
+
+    if (fromSnapshot) {
+        // SQLite is the source of truth; bring it in on a worker thread once
+        // startup has been measured.
+        QTimer::singleShot(0, &window, &MainWindow::reconcileAwards);
+    }
+
     return app.exec();
 }
@@ -1,6 +1,9 @@
 #include "mainwindow.h"
 #include "./ui_mainwindow.h"
 #include "udpreceiver.h"
+#include "exporter.h"
+#include "heatmapwidget.h"
+#include "stateserver.h"
 
 #include <QApplication>
 #include <QTableView>
@@ -18,15 +21,41 @@
 #include <QAbstractSocket>
 #include <QRegularExpression>
 #include <QEvent>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QItemSelectionModel>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QThread>
+#include <algorithm>
+#include <memory>
+
+// Bytes held in the RBN socket while paused before reading stops altogether.
+static constexpr qint64 kRbnPausedBufferBytes = 256 * 1024;
+// Delay before reconnecting to RBN; doubles after each failed attempt.
+static constexpr int kRbnReconnectMinMs = 5000;
+static constexpr int kRbnReconnectMaxMs = 60000;
+static const char *const kReconcileConnection = "reconcile";
+// Auto-reply: call a needed station at most once per cooldown, and warn when
+// decode-to-reply takes long enough to eat into the transmit window.
+static constexpr qint64 kAutoReplyCooldownMs = 5 * 60 * 1000;
+static constexpr qint64 kAutoReplyBudgetUs = 20 * 1000;
 
 // ✅ Custom delegate
 class CheckboxDelegate : public QStyledItemDelegate {
 public:
     using QStyledItemDelegate::QStyledItemDelegate;
 
-    void setModeVisibility(const std::array<bool, 4> &visible)
+    // Mode names in bit order, from the award definition.
+    void setModes(const QStringList &names)
     {
-        modeVisible = visible;
+        modes = names;
+    }
+
+    void setHiddenModes(const QSet<QString> &hidden)
+    {
+        hiddenModes = hidden;
     }
 
     void paint(QPainter *painter, const QStyleOptionViewItem &option,
@@ -39,16 +68,8 @@ public:
             painter->restore();
         }
         int bits = index.data(Qt::DisplayRole).toInt();
-        const QStringList symbols = {"CW", "PH", "FT8", "FT4"};
-
-        QVector<int> visibleIndices;
-        visibleIndices.reserve(4);
-        for (int i = 0; i < 4; ++i) {
-            if (modeVisible[i]) {
-                visibleIndices.push_back(i);
-            }
-        }
 
+        const QVector<int> visibleIndices = visibleModes();
         if (visibleIndices.isEmpty()) {
             return;
         }
@@ -73,7 +94,7 @@ public:
             painter->setBrush(Qt::NoBrush);
             painter->drawRoundedRect(boxRect, 4, 4);
             painter->setPen(checked ? Qt::red : Qt::gray);
-            painter->drawText(boxRect, Qt::AlignCenter, symbols[modeIndex]);
+            painter->drawText(boxRect, Qt::AlignCenter, modes[modeIndex]);
             painter->restore();
         }
     }
@@ -91,13 +112,7 @@ public:
                      const QModelIndex &index) override {
         if (event->type() == QEvent::MouseButtonRelease) {
             auto *mouseEvent = static_cast<QMouseEvent*>(event);
-            QVector<int> visibleIndices;
-            visibleIndices.reserve(4);
-            for (int i = 0; i < 4; ++i) {
-                if (modeVisible[i]) {
-                    visibleIndices.push_back(i);
-                }
-            }
+            const QVector<int> visibleIndices = visibleModes();
             if (visibleIndices.isEmpty()) {
                 return false;
             }
@@ -128,24 +143,35 @@ public:
     }
 
 private:
-    std::array<bool, 4> modeVisible{{true, true, true, true}};
+    QVector<int> visibleModes() const
+    {
+        QVector<int> visibleIndices;
+        visibleIndices.reserve(modes.size());
+        for (int i = 0; i < modes.size(); ++i) {
+            if (!hiddenModes.contains(modes[i])) {
+                visibleIndices.push_back(i);
+            }
+        }
+        return visibleIndices;
+    }
+
+    QStringList modes{"CW", "PH", "FT8", "FT4"};
+    QSet<QString> hiddenModes;
 };
 
-MainWindow::MainWindow(QWidget *parent)
+MainWindow::MainWindow(const AppConfig &config, AwardEngine *engine, QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , awards(engine)
+    , snapshotFile(config.snapshotFile)
+    , spotQueue(engine)
 {
     ui->setupUi(this);
 
+    checkboxDelegate = new CheckboxDelegate(ui->tableView);
+
     m_model = new QSqlTableModel(ui->tableView);
-    m_model->setTable("modes");
     m_model->setEditStrategy(QSqlTableModel::OnFieldChange);
-    const int callCol = m_model->fieldIndex("callsign");
-    if (callCol >= 0) {
-        m_model->setSort(callCol, Qt::AscendingOrder);
-    }
-    m_model->select();
-
     ui->tableView->setModel(m_model);
     // Single-row selection with light highlight
     ui->tableView->setSelectionMode(QAbstractItemView::SingleSelection);
@@ -153,18 +179,79 @@ MainWindow::MainWindow(QWidget *parent)
     ui->tableView->setStyleSheet(
         "QTableView::item:selected { background: #dfefff; color: palette(text); }");
 
-    ui->tableView->setColumnHidden(0, true);
+    showAward(0);
 
-    checkboxDelegate = new CheckboxDelegate(ui->tableView);
-    // ✅ Use the custom delegate on the 'bands' column
-    for (int i = 2; i < 10; i++)
-    {
-        ui->tableView->setItemDelegateForColumn(i, checkboxDelegate);
-        ui->tableView->setColumnWidth(i, 120);
+    // Only offer a choice when more than one award is active.
+    awardCombo = new QComboBox(this);
+    for (int i = 0; i < awards->awardCount(); ++i) {
+        awardCombo->addItem(awards->award(i).name);
+    }
+    awardCombo->setVisible(awards->awardCount() > 1);
+    ui->buttonsLayout->insertWidget(0, awardCombo);
+    connect(awardCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, [this](int award) {
+                showAward(award);
+                updateStatusCounts();
+            });
+
+    connect(ui->tableView->selectionModel(), &QItemSelectionModel::currentRowChanged,
+            this, [this](const QModelIndex &current, const QModelIndex &) {
+                showLastHeard(current.row());
+                showActivity(current.row());
+            });
+
+    for (int i = 0; i < awards->awardCount(); ++i) {
+        for (const QString &band : awards->award(i).bands) {
+            trackedBands.insert(band);
+        }
+    }
+
+    // Activity rows cover every award band, shortest wavelength first.
+    QVector<int> activityBands;
+    for (const QString &band : trackedBands) {
+        activityBands.append(band.toInt());
+    }
+    std::sort(activityBands.begin(), activityBands.end());
+
+    callsigns.open("WWA.calls");
+    spotHistory.open("WWA.spots");
+    activityStats.setBands(activityBands);
+    activityStats.load("WWA.activity", spotHistory);
+
+    heatMap = new HeatMapWidget(ui->logTab);
+    heatMap->setBands(activityBands);
+    ui->logGridLayout->addWidget(heatMap, 1, 0);
+
+    spotQueueTimer = new QTimer(this);
+    connect(spotQueueTimer, &QTimer::timeout, this, [this]() {
+        spotQueue.expire(QDateTime::currentMSecsSinceEpoch());
+        refreshSpotTable();
+        updateFilterStatus();
+    });
+    spotQueueTimer->start(1000);
+
+    stateServer = new StateServer(awards, this);
+    stateServer->start(config.sharedStateFile, config.stateSocket);
+
+    // Target lists are watched; editors that save by rename drop the watch,
+    // so paths are re-added after every change. Saves often arrive as
+    // several writes, hence the short delay before syncing.
+    targetWatcher = new QFileSystemWatcher(this);
+    targetSyncTimer = new QTimer(this);
+    targetSyncTimer->setSingleShot(true);
+    targetSyncTimer->setInterval(300);
+    connect(targetSyncTimer, &QTimer::timeout, this, &MainWindow::syncTargetLists);
+    connect(targetWatcher, &QFileSystemWatcher::fileChanged, targetSyncTimer, qOverload<>(&QTimer::start));
+    for (int i = 0; i < awards->awardCount(); ++i) {
+        const QString &path = awards->award(i).targetsFile;
+        if (!path.isEmpty() && QFileInfo::exists(path)) {
+            targetWatcher->addPath(path);
+        }
     }
 
     connect(m_model, &QAbstractItemModel::dataChanged,
-            this, [this](const QModelIndex &, const QModelIndex &, const QVector<int> &) {
+            this, [this](const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &) {
+                syncAwardCells(topLeft, bottomRight);
                 updateStatusCounts();
             });
 
@@ -172,25 +259,46 @@ MainWindow::MainWindow(QWidget *parent)
             this, &MainWindow::onAddClicked);
     connect(ui->clearButton, &QPushButton::clicked,
             this, &MainWindow::onClearClicked);
+    connect(ui->actionExport, &QAction::triggered,
+            this, &MainWindow::onExportClicked);
 
     connect(ui->cwCheckBox, &QCheckBox::toggled, this, [this]() { updateModeVisibility(); });
     connect(ui->phCheckBox, &QCheckBox::toggled, this, [this]() { updateModeVisibility(); });
     connect(ui->ft8CheckBox, &QCheckBox::toggled, this, [this]() { updateModeVisibility(); });
     connect(ui->ft4CheckBox, &QCheckBox::toggled, this, [this]() { updateModeVisibility(); });
 
+    ui->autoReplyCheckBox->setChecked(config.autoReply);
+
     udp = new UdpReceiver(this);
 
     connect(udp, &UdpReceiver::qsoLogged,
             this, &MainWindow::onQsoLogged);
-
-    udp->start(2333);
+    connect(udp, &UdpReceiver::decoded,
+            this, &MainWindow::onDecoded);
+    connect(udp, &UdpReceiver::instanceUpdated,
+            this, [this](const QString &) { updateInstanceStatus(); });
+    connect(udp, &UdpReceiver::instanceClosed,
+            this, [this](const QString &) { updateInstanceStatus(); });
+
+    for (const QString &endpoint : config.udpEndpoints) {
+        QHostAddress address;
+        quint16 port = 0;
+        if (!UdpReceiver::parseEndpoint(endpoint, &address, &port)) {
+            qWarning() << "Invalid UDP endpoint:" << endpoint;
+            continue;
+        }
+        udp->addEndpoint(address, port);
+    }
 
     statusCountsLabel = new QLabel(this);
     statusCountsLabel->setMinimumWidth(260);
     statusCountsLabel->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    statusRigsLabel = new QLabel(this);
+    statusRigsLabel->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
     statusInfoLabel = new QLabel(this);
     statusInfoLabel->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
     ui->statusbar->addWidget(statusInfoLabel, 1);
+    ui->statusbar->addPermanentWidget(statusRigsLabel);
     ui->statusbar->addPermanentWidget(statusCountsLabel);
     statusInfoLabel->setText("Ready");
     updateStatusCounts();
@@ -198,215 +306,349 @@ MainWindow::MainWindow(QWidget *parent)
     ui->statusbar->installEventFilter(this);
 
     rbnSocket = new QTcpSocket(this);
-    connect(rbnSocket, &QTcpSocket::readyRead, this, [this]() {
-        const QByteArray data = rbnSocket->readAll();
-        if (data.isEmpty()) {
-            return;
-        }
-
-        rbnBuffer.append(data);
-        // qDebug().noquote() << "RBN:" << data;
-
-        static const QRegularExpression rbnLineRegex(
-            R"(^DX de\s+\S+:\s+([0-9.]+)\s+([A-Za-z0-9/]+)\b(?:\s+([A-Za-z0-9/]+))?)"
-        );
-        auto freqToBand = [](double value) -> QString {
-            // RBN spots often use kHz (e.g. 14074.0); normalize to MHz.
-            double mhz = value;
-            if (mhz > 1000.0) {
-                mhz /= 1000.0;
-            }
-
-            if (mhz >= 3.5 && mhz < 4.0) return "80";
-            if (mhz >= 7.0 && mhz < 7.3) return "40";
-            if (mhz >= 10.1 && mhz < 10.15) return "30";
-            if (mhz >= 14.0 && mhz < 14.35) return "20";
-            if (mhz >= 18.068 && mhz < 18.168) return "17";
-            if (mhz >= 21.0 && mhz < 21.45) return "15";
-            if (mhz >= 24.89 && mhz < 24.99) return "12";
-            if (mhz >= 28.0 && mhz < 29.7) return "10";
-            return QString();
-        };
-
-        if (rbnOutputPaused) {
-            if (!rbnLoginSent && rbnBuffer.contains("Please enter your call:")) {
-                rbnSocket->write("OG3Z\r\n");
-                rbnLoginSent = true;
-                qDebug() << "RBN login sent";
-            }
-            rbnBuffer.clear();
-            return;
-        }
-
-        while (true) {
-            const int newlineIndex = rbnBuffer.indexOf('\n');
-            if (newlineIndex < 0) {
-                break;
-            }
-
-            const QByteArray lineBytes = rbnBuffer.left(newlineIndex);
-            rbnBuffer.remove(0, newlineIndex + 1);
-
-            const QString line = QString::fromUtf8(lineBytes).trimmed();
-            if (line.isEmpty()) {
-                continue;
-            }
-
-            qDebug().noquote() << line;
-
-            const QRegularExpressionMatch match = rbnLineRegex.match(line);
-            if (match.hasMatch()) {
-                const QString freq = match.captured(1);
-                const QString call = match.captured(2);
-                const QString callUp = call.trimmed().toUpper();
-                const QString mode = match.captured(3).trimmed().toUpper();
-                const double freqValue = freq.toDouble();
-                const QString band = freqToBand(freqValue);
-                // qDebug().noquote() << "RBN spot:" << "call=" << call << "freq=" << freq;
-
-                if (band.isEmpty()) {
-                    return;
-                }
-
-                QSqlQuery q;
-                const QString sql = QString(R"(SELECT "%1" FROM modes WHERE callsign = ? LIMIT 1)").arg(band);
-                q.prepare(sql);
-                q.addBindValue(callUp);
-                if (!q.exec()) {
-                    qWarning() << "RBN DB lookup failed:" << q.lastError();
-                } else if (q.next()) {
-                    const int mask = q.value(0).toInt();
-                    //qDebug().noquote() << "RBN in DB:" << callUp;
-                    if (!(mask & (1 << 0))) {
-                        //qDebug().noquote() << callUp << mode << freq;
-                        if (statusInfoLabel && mode == "CW") {
-                            statusInfoLabel->setText(QString("%1 %2").arg(callUp, freq));
-                        } else {
-                            qDebug() << "RBN non-CW:" << callUp << freq << "mode" << (mode.isEmpty() ? "<none>" : mode);
-                        }
-                    }
-                }
-            }
-        }
-
-        if (!rbnLoginSent && rbnBuffer.contains("Please enter your call:")) {
-            rbnSocket->write("OG3Z\r\n");
-            rbnLoginSent = true;
-            qDebug() << "RBN login sent";
-        }
-    });
+    connect(rbnSocket, &QTcpSocket::readyRead, this, &MainWindow::onRbnReadyRead);
     connect(rbnSocket,
             QOverload<QAbstractSocket::SocketError>::of(&QTcpSocket::errorOccurred),
             this, [this](QAbstractSocket::SocketError) {
                 qWarning() << "RBN socket error:" << rbnSocket->errorString();
+                // A failed connect attempt never emits disconnected().
+                if (rbnSocket->state() == QAbstractSocket::UnconnectedState) {
+                    scheduleRbnReconnect();
+                }
             });
     connect(rbnSocket, &QTcpSocket::connected, this, [this]() {
         qDebug() << "RBN connected";
+        rbnReconnectMs = kRbnReconnectMinMs;
+        if (statusInfoLabel) {
+            statusInfoLabel->setStyleSheet(rbnOutputPaused ? "color: red;" : "");
+            statusInfoLabel->setText("RBN connected");
+        }
     });
     connect(rbnSocket, &QTcpSocket::disconnected, this, [this]() {
+        // The server may drop a client that stops reading; whatever it had
+        // already sent is still in our buffer, so process it rather than lose it.
+        const qint64 held = rbnSocket->bytesAvailable();
+        if (rbnOutputPaused && held > 0) {
+            qWarning() << "RBN disconnected while paused," << held << "bytes held; processing them";
+            drainRbn();
+        }
         qWarning() << "RBN disconnected";
+        scheduleRbnReconnect();
     });
-    rbnSocket->connectToHost("telnet.reversebeacon.net", 7000);
+
+    rbnReconnectTimer = new QTimer(this);
+    rbnReconnectTimer->setSingleShot(true);
+    connect(rbnReconnectTimer, &QTimer::timeout, this, &MainWindow::connectRbn);
+
+    rbnHost = config.rbnEndpoint;
+    const int colon = rbnHost.lastIndexOf(':');
+    if (colon > 0) {
+        rbnPort = quint16(rbnHost.mid(colon + 1).toUInt());
+        rbnHost.truncate(colon);
+    }
+    rbnCall = config.rbnCall.toLatin1();
+    if (rbnPort == 0 || rbnHost.isEmpty()) {
+        qWarning() << "Invalid RBN endpoint:" << config.rbnEndpoint;
+        rbnHost.clear();
+    } else {
+        connectRbn();
+    }
+
+    measureLatency = config.measureLatency;
+    if (measureLatency) {
+        ingestClock.start();
+        auto *statsTimer = new QTimer(this);
+        connect(statsTimer, &QTimer::timeout, this, &MainWindow::logIngestStats);
+        statsTimer->start(10000);
+    }
  }
 
 MainWindow::~MainWindow()
 {
+    if (reconcileThread) {
+        reconcileThread->wait();
+    }
+    activityStats.save("WWA.activity", spotHistory);
+    awards->saveSnapshot(snapshotFile);
     delete ui;
 }
 
 bool MainWindow::eventFilter(QObject *obj, QEvent *event)
 {
     if (obj == ui->statusbar && event->type() == QEvent::MouseButtonPress) {
-        rbnOutputPaused = !rbnOutputPaused;
-        if (statusInfoLabel) {
-            statusInfoLabel->setStyleSheet(rbnOutputPaused ? "color: red;" : "");
-        }
+        setRbnPaused(!rbnOutputPaused);
         return true;
     }
     return QMainWindow::eventFilter(obj, event);
 }
 
-void MainWindow::onQsoLogged(const QString &call, const QString &band, const QString &mode)
+void MainWindow::setRbnPaused(bool paused)
 {
-    const QString callUp = call.trimmed().toUpper();
-    const QString bandCol = band.trimmed();          // expects: "10","12","15","17","20","30","40","80"
-    const QString modeUp = mode.trimmed().toUpper(); // "FT8" or "FT4"
-
-    qDebug().noquote() << "MainWindow slot: QSO logged -> call=" << callUp
-                       << "band=" << bandCol
-                       << "mode=" << modeUp;
+    rbnOutputPaused = paused;
+    if (statusInfoLabel) {
+        statusInfoLabel->setStyleSheet(rbnOutputPaused ? "color: red;" : "");
+    }
 
-    // Map mode to your bitmask (CW=0, PH=1, FT8=2, FT4=3)
-    int bit = -1;
-    if (modeUp == "FT8") bit = 2;
-    else if (modeUp == "FT4") bit = 3;
-    else {
-        qDebug() << "Ignoring mode (not FT8/FT4):" << modeUp;
+    if (paused) {
+        // Stop reading: once the socket buffer holds this much, Qt stops
+        // pulling from the OS, the TCP window closes and the server waits.
+        rbnSocket->setReadBufferSize(kRbnPausedBufferBytes);
         return;
     }
 
-    // IMPORTANT: band is used as a column name, so we must validate it.
-    static const QSet<QString> allowedBands = {"10","12","15","17","20","30","40","80"};
-    if (!allowedBands.contains(bandCol)) {
-        qWarning() << "Ignoring unknown band column:" << bandCol;
+    rbnSocket->setReadBufferSize(0);
+    drainRbn();
+    if (rbnSocket->state() == QAbstractSocket::UnconnectedState && !rbnHost.isEmpty()) {
+        connectRbn();
+    }
+}
+
+void MainWindow::connectRbn()
+{
+    if (rbnSocket->state() != QAbstractSocket::UnconnectedState) {
         return;
     }
+    // A new session starts with the login prompt and no partial line.
+    rbnBuffer.clear();
+    rbnLoginSent = false;
+    rbnSocket->connectToHost(rbnHost, rbnPort);
+}
 
-    QSqlQuery q;
+void MainWindow::scheduleRbnReconnect()
+{
+    if (rbnReconnectTimer->isActive()) {
+        return;
+    }
+    if (statusInfoLabel) {
+        statusInfoLabel->setStyleSheet("color: red;");
+    }
 
-    // 1) Check if call exists and read current mask value in that band column
-    const QString selectSql = QString(R"(
-        SELECT id, "%1" FROM modes WHERE callsign = ?
-    )").arg(bandCol);
+    // While paused the server would drop us again as soon as our buffer
+    // filled, so wait for resume; setRbnPaused(false) reconnects.
+    if (rbnOutputPaused) {
+        if (statusInfoLabel) {
+            statusInfoLabel->setText("RBN disconnected while paused; click to resume and reconnect");
+        }
+        return;
+    }
 
-    q.prepare(selectSql);
-    q.addBindValue(callUp);
+    if (statusInfoLabel) {
+        statusInfoLabel->setText(QString("RBN disconnected, reconnecting in %1 s").arg(rbnReconnectMs / 1000));
+    }
+    rbnReconnectTimer->start(rbnReconnectMs);
+    rbnReconnectMs = qMin(rbnReconnectMs * 2, kRbnReconnectMaxMs);
+}
 
-    if (!q.exec()) {
-        qWarning() << "Select failed:" << q.lastError();
+void MainWindow::onRbnReadyRead()
+{
+    // The login prompt is answered even while paused.
+    if (rbnOutputPaused && rbnLoginSent) {
+        if (statusInfoLabel) {
+            statusInfoLabel->setText(QString("RBN paused, %1 KB held")
+                                         .arg(rbnSocket->bytesAvailable() / 1024));
+        }
         return;
     }
+    drainRbn();
+}
+
+// Checkbox index (CW, PH, FT8, FT4) for a spot mode, -1 for anything else.
+static int modeCheckIndex(const char *p, int n)
+{
+    const QByteArray mode = QByteArray::fromRawData(p, n);
+    if (mode == "CW") return 0;
+    if (mode == "SSB" || mode == "USB" || mode == "LSB" || mode == "AM" || mode == "FM") return 1;
+    if (mode == "FT8") return 2;
+    if (mode == "FT4") return 3;
+    return -1;
+}
+
+// First, cheap look at an RBN line: splits "DX de SKIMMER-#:  14025.0  CALL  CW ..."
+// on the raw bytes and returns the frequency in Hz and the mode field,
+// without building any strings. False if the line is not a spot.
+static bool peekRbnSpot(const QByteArray &line, quint64 *freqHz, const char **mode, int *modeLength)
+{
+    if (!line.startsWith("DX de ")) {
+        return false;
+    }
+
+    const char *fields[6] = {};
+    int lengths[6] = {};
+    int count = 0;
+    const char *p = line.constData();
+    const char *end = p + line.size();
+    while (p < end && count < 6) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+        const char *start = p;
+        while (p < end && *p != ' ' && *p != '\t' && *p != '\r') ++p;
+        if (p > start) {
+            fields[count] = start;
+            lengths[count] = int(p - start);
+            ++count;
+        }
+    }
+    if (count < 5) {
+        return false;
+    }
 
-    if (!q.next()) {
-        qDebug() << "Call not found in DB, ignoring:" << callUp;
-        return; // "if call exists in db" -> only update when it exists
+    // 0 "DX", 1 "de", 2 "SKIMMER-#:", 3 kHz, 4 call, 5 mode
+    bool ok = false;
+    const double khz = QByteArray::fromRawData(fields[3], lengths[3]).toDouble(&ok);
+    if (!ok) {
+        return false;
     }
+    *freqHz = quint64(khz * 1000.0);
+    *mode = fields[5];
+    *modeLength = lengths[5];
+    return true;
+}
 
-    const int id = q.value(0).toInt();
-    const int currentMask = q.value(1).toInt();
-    const int newMask = currentMask | (1 << bit);
+void MainWindow::drainRbn()
+{
+    static const QRegularExpression rbnLineRegex(
+        R"(^DX de\s+(\S+):\s+([0-9.]+)\s+([A-Za-z0-9/]+)\b(?:\s+([A-Za-z0-9/]+))?(?:\s+(-?\d+)\s+dB)?)"
+    );
 
-    if (newMask == currentMask) {
-        qDebug() << "Already set, no DB update needed for" << callUp << "band" << bandCol << "mode" << modeUp;
+    const QByteArray data = rbnSocket->readAll();
+    if (data.isEmpty()) {
         return;
     }
 
-    // 2) Update the band column
-    QSqlQuery u;
-    const QString updateSql = QString(R"(
-        UPDATE modes SET "%1" = ? WHERE id = ?
-    )").arg(bandCol);
+    rbnBuffer.append(data);
+    // qDebug().noquote() << "RBN:" << data;
+
+    QElapsedTimer busy;
+    if (measureLatency) {
+        busy.start();
+    }
+
+    while (true) {
+        const int newlineIndex = rbnBuffer.indexOf('\n');
+        if (newlineIndex < 0) {
+            break;
+        }
 
-    u.prepare(updateSql);
-    u.addBindValue(newMask);
-    u.addBindValue(id);
+        const QByteArray lineBytes = rbnBuffer.left(newlineIndex);
+        rbnBuffer.remove(0, newlineIndex + 1);
+
+        // Filter stage: band and mode from the raw fields, before any
+        // string is built or callsign looked up.
+        quint64 peekHz = 0;
+        const char *peekMode = nullptr;
+        int peekModeLength = 0;
+        if (peekRbnSpot(lineBytes, &peekHz, &peekMode, &peekModeLength)) {
+            ++rbnFilter.spots;
+            ++ingest.rbnLines;
+            const QString peekBand = UdpReceiver::bandFromHz(peekHz);
+            if (peekBand.isEmpty() || !trackedBands.contains(peekBand)) {
+                ++rbnFilter.offBand;
+                continue;
+            }
+            const int modeIndex = modeCheckIndex(peekMode, peekModeLength);
+            if (modeIndex >= 0 && rigModes[modeIndex]
+                && !rigBandModes.contains(qMakePair(peekBand, modeIndex))) {
+                ++rbnFilter.noRig;
+                continue;
+            }
+            if (modeIndex >= 0 && !modeVisible[modeIndex]) {
+                ++rbnFilter.modeOff;
+                continue;
+            }
+        }
+
+        const QString line = QString::fromUtf8(lineBytes).trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        // qDebug().noquote() << line;
+
+        const QRegularExpressionMatch match = rbnLineRegex.match(line);
+        if (match.hasMatch()) {
+            const QString skimmer = match.captured(1).trimmed().toUpper();
+            const QString freq = match.captured(2);
+            const QString call = match.captured(3);
+            const QString callUp = call.trimmed().toUpper();
+            const QString mode = match.captured(4).trimmed().toUpper();
+            const int snr = match.captured(5).toInt();
+            // RBN reports kHz (e.g. 14074.0)
+            const double freqValue = freq.toDouble();
+            const quint64 freqHz = quint64(freqValue * 1000.0);
+            const QString band = UdpReceiver::bandFromHz(freqHz);
+            // qDebug().noquote() << "RBN spot:" << "call=" << call << "freq=" << freq;
+
+            if (band.isEmpty()) {
+                continue;   // outside our bands; keep going with the next line
+            }
+
+            // One lookup covers every active award.
+            const QVector<AwardEngine::Slot> *slots = awards->lookup(callUp);
+            if (!slots) {
+                ++rbnFilter.notTarget;
+            } else {
+                ++rbnFilter.passed;
+                ++ingest.rbnSpots;
+                recordSpot(SpotHistory::SourceRbn, callUp, skimmer, band, quint32(freqHz), mode, snr);
+                spotQueue.add(callUp, band, mode, quint32(freqHz), skimmer, QDateTime::currentMSecsSinceEpoch(),
+                              awards->pointGain(*slots, band, mode));
+                //qDebug().noquote() << "RBN in DB:" << callUp;
+                if (awards->isNeeded(*slots, band, mode)) {
+                    //qDebug().noquote() << callUp << mode << freq;
+                    if (statusInfoLabel) {
+                        statusInfoLabel->setText(QString("%1 %2 %3").arg(callUp, freq, mode));
+                    }
+                }
+            }
+        }
+    }
+
+    if (measureLatency) {
+        ingest.rbnBusyMs += busy.elapsed();
+    }
 
-    if (!u.exec()) {
-        qWarning() << "Update failed:" << u.lastError();
+    if (!rbnLoginSent && rbnBuffer.contains("Please enter your call:")) {
+        rbnSocket->write(rbnCall + "\r\n");
+        rbnLoginSent = true;
+        qDebug() << "RBN login sent";
+    }
+}
+
+void MainWindow::onQsoLogged(const QString &instanceId, const QString &call, const QString &band, const QString &mode)
+{
+    const QString callUp = call.trimmed().toUpper();
+    const QString bandCol = band.trimmed();          // band name, e.g. "20"
+    const QString modeUp = AwardEngine::normalizeMode(mode);
+
+    qDebug().noquote() << "MainWindow slot: QSO logged -> instance=" << instanceId
+                       << "call=" << callUp
+                       << "band=" << bandCol
+                       << "mode=" << modeUp;
+
+    if (!awards->lookup(callUp)) {
+        qDebug() << "Call not found in any award, ignoring:" << callUp;
+        return;
+    }
+
+    const QVector<int> changed = awards->applyQso(callUp, bandCol, modeUp);
+    if (changed.isEmpty()) {
+        qDebug() << "Already set, no DB update needed for" << callUp << "band" << bandCol << "mode" << modeUp;
         return;
     }
 
     qDebug().noquote() << "DB updated:" << callUp
                        << "band" << bandCol
-                       << "mask" << currentMask << "->" << newMask;
+                       << "mode" << modeUp
+                       << "awards" << changed.size();
 
-    auto *m = qobject_cast<QSqlTableModel*>(ui->tableView->model()); // TODO:
-    if (m) m->select();
+    if (changed.contains(currentAward)) {
+        m_model->select();
+    }
+    spotQueue.refreshCall(callUp);
 
     updateStatusCounts();
 
     if (statusInfoLabel) {
-        statusInfoLabel->setText(QString("Logged %1 on %2m %3").arg(call, band, mode));
+        statusInfoLabel->setText(QString("Logged %1 on %2m %3 (%4)").arg(call, band, mode, instanceId));
     }
 }
 
@@ -418,14 +660,9 @@ void MainWindow::onAddClicked()
 
     QSqlRecord rec = m_model->record();
     rec.setValue("callsign", "");
-    rec.setValue("10", 0);
-    rec.setValue("12", 0);
-    rec.setValue("15", 0);
-    rec.setValue("17", 0);
-    rec.setValue("20", 0);
-    rec.setValue("30", 0);
-    rec.setValue("40", 0);
-    rec.setValue("80", 0);
+    for (const QString &band : awards->award(currentAward).bands) {
+        rec.setValue(band, 0);
+    }
 
     if (!m_model->insertRecord(-1, rec)) {
         qWarning() << "Insert failed:" << m_model->lastError();
@@ -445,6 +682,7 @@ void MainWindow::onAddClicked()
     }
 
     m_model->select();
+    awards->reloadAward(currentAward);
     updateStatusCounts();
     if (statusInfoLabel) {
         statusInfoLabel->setText("Added empty record");
@@ -456,7 +694,7 @@ void MainWindow::onClearClicked()
     const auto response = QMessageBox::question(
         this,
         "Confirm Clear",
-        "Set every band value to 0 for all callsigns?",
+        QString("Set every band value to 0 for all callsigns in %1?").arg(awards->award(currentAward).name),
         QMessageBox::Yes | QMessageBox::No,
         QMessageBox::No
         );
@@ -465,21 +703,7 @@ void MainWindow::onClearClicked()
         return;
     }
 
-    QSqlQuery q;
-    const QString sql = R"(
-        UPDATE modes SET
-            "10" = 0,
-            "12" = 0,
-            "15" = 0,
-            "17" = 0,
-            "20" = 0,
-            "30" = 0,
-            "40" = 0,
-            "80" = 0
-    )";
-
-    if (!q.exec(sql)) {
-        qWarning() << "Clear failed:" << q.lastError();
+    if (!awards->clear(currentAward)) {
         if (statusInfoLabel) {
             statusInfoLabel->setText("Clear failed");
         }
@@ -489,48 +713,220 @@ void MainWindow::onClearClicked()
     if (m_model) {
         m_model->select();
     }
+    spotQueue.refreshAll();
+    refreshSpotTable();
     updateStatusCounts();
     if (statusInfoLabel) {
         statusInfoLabel->setText("Cleared all data");
     }
 }
 
-void MainWindow::updateStatusCounts()
-{
-    int cw = 0, ph = 0, ft8 = 0, ft4 = 0;
+void MainWindow::reconcileAwards()
+{
+    if (reconcileThread) {
+        return;     // one run at a time
+    }
 
-    static const QStringList bands = {
-        "10","12","15","17","20","30","40","80"
+    // Seeding new targets, re-reading every award table and building the
+    // call tables run on a copy of the engine with its own connection, so
+    // the window stays responsive. The result replaces the live state only
+    // if nothing changed it meanwhile.
+    struct Result {
+        bool ok = false;
+        bool changed = false;       // the database differed from the snapshot
+        QByteArray snapshot;        // encoded for writing on this thread
     };
+    auto fresh = std::make_shared<AwardEngine>(*awards);
+    auto result = std::make_shared<Result>();
+    const quint64 startGeneration = awards->generation();
+    const QString databaseName = QSqlDatabase::database().databaseName();
+
+    reconcileThread = QThread::create([fresh, result, databaseName]() {
+        QElapsedTimer timer;
+        timer.start();
+        const quint64 before = fresh->stateChecksum();
+        {
+            QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", kReconcileConnection);
+            db.setDatabaseName(databaseName);
+            if (db.open()) {
+                fresh->setConnectionName(kReconcileConnection);
+                result->ok = fresh->setupTables() && fresh->loadState();
+                db.close();
+            } else {
+                qWarning() << "Cannot open database for reconcile:" << db.lastError();
+            }
+        }
+        QSqlDatabase::removeDatabase(kReconcileConnection);
+        if (result->ok) {
+            result->changed = fresh->stateChecksum() != before;
+            result->snapshot = fresh->snapshotData();
+        }
+        qDebug() << "Award state re-read from database in" << timer.elapsed() << "ms";
+    });
 
-    QSqlQuery q;
+    connect(reconcileThread, &QThread::finished, this, [this, fresh, result, startGeneration]() {
+        reconcileThread->deleteLater();
+        reconcileThread = nullptr;
 
-    for (const QString &band : bands) {
-        const QString sql = QString(R"(SELECT "%1" FROM modes)").arg(band);
-        if (!q.exec(sql)) {
-            qWarning() << "Count query failed:" << q.lastError();
+        if (!result->ok) {
+            qWarning() << "Reconciling award state with the database failed";
             return;
         }
 
-        while (q.next()) {
-            const int mask = q.value(0).toInt();
-            if (mask & (1 << 0)) cw++;
-            if (mask & (1 << 1)) ph++;
-            if (mask & (1 << 2)) ft8++;
-            if (mask & (1 << 3)) ft4++;
+        // The snapshot has no target lists; take them every time, whatever
+        // happens to the rows below, and run any sync held back for them.
+        awards->adoptTargets(*fresh);
+        if (targetSyncPending) {
+            targetSyncPending = false;
+            targetSyncTimer->start();
+        }
+
+        if (awards->generation() != startGeneration) {
+            // A QSO or edit landed while the copy was read; it may predate
+            // that write, so read again.
+            QTimer::singleShot(0, this, &MainWindow::reconcileAwards);
+            return;
+        }
+
+        // Always adopted, changed or not: the copy has the call tables and
+        // index, and taking them lets go of the snapshot mapping, which is
+        // what allows the file to be replaced.
+        awards->adoptState(*fresh);
+        AwardEngine::writeSnapshot(snapshotFile, result->snapshot);
+        if (result->changed) {
+            qDebug() << "Snapshot was stale, award state refreshed from database";
+            showAward(currentAward);
+            updateStatusCounts();
+            spotQueue.refreshAll();
+            refreshSpotTable();
+        }
+    });
+    reconcileThread->start();
+}
+
+void MainWindow::syncTargetLists()
+{
+    // After a snapshot start the target lists are only known once the
+    // reconcile has read them; until then a sync could not tell which calls
+    // were dropped.
+    if (!awards->targetsKnown()) {
+        targetSyncPending = true;
+        return;
+    }
+
+    bool anyChanged = false;
+    int currentAdded = 0;
+    QVector<qint64> currentRemovedIds;
+    for (int i = 0; i < awards->awardCount(); ++i) {
+        const QString &path = awards->award(i).targetsFile;
+        if (path.isEmpty() || !QFileInfo::exists(path)) {
+            continue;
+        }
+        if (!targetWatcher->files().contains(path)) {
+            targetWatcher->addPath(path);
+        }
+
+        int added = 0;
+        int removed = 0;
+        QVector<qint64> removedIds;
+        if (!awards->syncTargets(i, &added, &removed, &removedIds)) {
+            qWarning() << "Target list sync failed for" << awards->award(i).name;
+            continue;
+        }
+        if (added == 0 && removed == 0) {
+            continue;
+        }
+        qDebug().noquote() << "Targets for" << awards->award(i).name << "+" << added << "-" << removed;
+        anyChanged = true;
+        if (i == currentAward) {
+            currentAdded = added;
+            currentRemovedIds = removedIds;
+        }
+        if (statusInfoLabel) {
+            statusInfoLabel->setText(QString("%1: %2 targets added, %3 removed")
+                                         .arg(awards->award(i).name).arg(added).arg(removed));
+        }
+    }
+
+    if (anyChanged) {
+        // Dropped targets leave the queue; new ones are ranked on their next spot.
+        spotQueue.refreshAll();
+        refreshSpotTable();
+    }
+    if (currentAdded > 0) {
+        // New rows can only come from the database; the model fetches in
+        // batches, so this reads what is on screen, not the whole table.
+        m_model->select();
+    } else if (!currentRemovedIds.isEmpty()) {
+        // Removed rows are gone from the database already; hide them until
+        // the next select() rather than re-reading the table.
+        const QSet<qint64> gone(currentRemovedIds.cbegin(), currentRemovedIds.cend());
+        const int idCol = m_model->fieldIndex("id");
+        for (int row = 0; row < m_model->rowCount(); ++row) {
+            if (gone.contains(m_model->data(m_model->index(row, idCol)).toLongLong())) {
+                ui->tableView->setRowHidden(row, true);
+            }
+        }
+    }
+    if (currentAdded > 0 || !currentRemovedIds.isEmpty()) {
+        updateStatusCounts();
+    }
+}
+
+void MainWindow::onExportClicked()
+{
+    QString selectedFilter;
+    const QString path = QFileDialog::getSaveFileName(
+        this,
+        "Export",
+        awards->award(currentAward).name + ".csv",
+        "CSV award state (*.csv);;JSON award state (*.json);;ADIF worked stations (*.adi)",
+        &selectedFilter
+        );
+
+    if (path.isEmpty()) {
+        return;
+    }
+
+    Exporter::Format format = Exporter::Format::Csv;
+    if (!Exporter::formatFromPath(path, &format)) {
+        if (selectedFilter.startsWith("JSON")) format = Exporter::Format::Json;
+        else if (selectedFilter.startsWith("ADIF")) format = Exporter::Format::Adif;
+    }
+
+    QString error;
+    if (!Exporter::exportAwardToFile(awards->award(currentAward), format, path, &error)) {
+        qWarning() << "Export failed:" << error;
+        if (statusInfoLabel) {
+            statusInfoLabel->setText("Export failed");
         }
+        return;
     }
 
-    const int total = cw * 10 + ph * 5 + ft8 * 2 + ft4 * 2;
+    if (statusInfoLabel) {
+        statusInfoLabel->setText(QString("Exported %1").arg(path));
+    }
+}
+
+void MainWindow::updateStatusCounts()
+{
+    QStringList parts;
 
-    statusCountsLabel->setText(
-        QString("CW:%1  PH:%2  FT8:%3  FT4:%4  TOTAL:%5")
-            .arg(cw)
-            .arg(ph)
-            .arg(ft8)
-            .arg(ft4)
-            .arg(total)
-        );
+    // Current award in full, the others as totals only.
+    const AwardDefinition &def = awards->award(currentAward);
+    const AwardEngine::Totals current = awards->totals(currentAward);
+    for (int bit = 0; bit < def.modes.size(); ++bit) {
+        parts << QString("%1:%2").arg(def.modes[bit].name).arg(current.perMode[bit]);
+    }
+    parts << QString("TOTAL:%1").arg(current.points);
+
+    for (int i = 0; i < awards->awardCount(); ++i) {
+        if (i != currentAward) {
+            parts << QString("| %1:%2").arg(awards->award(i).name).arg(awards->totals(i).points);
+        }
+    }
+
+    statusCountsLabel->setText(parts.join("  "));
 }
 
 void MainWindow::updateModeVisibility()
@@ -540,8 +936,330 @@ void MainWindow::updateModeVisibility()
     modeVisible[2] = ui->ft8CheckBox->isChecked();
     modeVisible[3] = ui->ft4CheckBox->isChecked();
 
+    static const QStringList names = {"CW", "PH", "FT8", "FT4"};
+    QSet<QString> hidden;
+    for (int i = 0; i < 4; ++i) {
+        if (!modeVisible[i]) {
+            hidden.insert(names[i]);
+        }
+    }
+
     if (checkboxDelegate) {
-        checkboxDelegate->setModeVisibility(modeVisible);
+        checkboxDelegate->setHiddenModes(hidden);
     }
     ui->tableView->viewport()->update();
 }
+
+void MainWindow::updateInstanceStatus()
+{
+    if (!statusRigsLabel || !udp) {
+        return;
+    }
+
+    QStringList parts;
+    QStringList details;
+    rigBandModes.clear();
+    rigModes.fill(false);
+    const auto &instances = udp->instances();
+    for (auto it = instances.cbegin(); it != instances.cend(); ++it) {
+        const WsjtxInstance &inst = it.value();
+        const QString band = UdpReceiver::bandFromHz(inst.dialFreqHz);
+        const QByteArray mode = inst.mode.trimmed().toUpper().toLatin1();
+        const int modeIndex = modeCheckIndex(mode.constData(), mode.size());
+        if (!band.isEmpty() && modeIndex >= 0) {
+            rigBandModes.insert(qMakePair(band, modeIndex));
+            rigModes[modeIndex] = true;
+        }
+        const QString mhz = inst.dialFreqHz ? QString::number(inst.dialFreqHz / 1e6, 'f', 3) : QString("?");
+        parts << QString("%1 %2 %3").arg(inst.id, mhz, inst.mode);
+        details << QString("%1: %2 MHz %3, %4:%5, heartbeat %6%7")
+                       .arg(inst.id, mhz, inst.mode, inst.address.toString())
+                       .arg(inst.port)
+                       .arg(inst.lastHeartbeat.isValid() ? inst.lastHeartbeat.toString("HH:mm:ss") : QString("-"))
+                       .arg(inst.transmitting ? ", TX" : "");
+    }
+    parts.sort();
+    details.sort();
+    statusRigsLabel->setText(parts.join("  |  "));
+    statusRigsLabel->setToolTip(details.join("\n"));
+}
+
+void MainWindow::onDecoded(const QString &instanceId, const QTime &time, int snr, double deltaTime,
+                           quint32 deltaFreq, const QString &mode, const QString &message, bool lowConfidence)
+{
+    if (measureLatency) {
+        // Only meaningful when the sender stamps decodes with the send time
+        // (wwa-loadgen does); WSJT-X stamps the start of the T/R period.
+        static constexpr qint64 kDayMs = 24 * 3600 * 1000;
+        const qint64 nowMs = QDateTime::currentDateTimeUtc().time().msecsSinceStartOfDay();
+        const qint64 latencyMs = (nowMs - time.msecsSinceStartOfDay() + kDayMs) % kDayMs;
+        ++ingest.decodes;
+        ingest.latencySumMs += latencyMs;
+        ingest.latencyMaxMs = qMax(ingest.latencyMaxMs, latencyMs);
+    }
+
+    const QString caller = UdpReceiver::callerFromMessage(message);
+    if (caller.isEmpty()) {
+        return;
+    }
+
+    const auto &instances = udp->instances();
+    const auto it = instances.constFind(instanceId);
+    if (it == instances.constEnd() || it->dialFreqHz == 0) {
+        return;     // no Status yet, band unknown
+    }
+
+    const QString band = UdpReceiver::bandFromHz(it->dialFreqHz);
+    if (band.isEmpty()) {
+        return;
+    }
+
+    // The decode's mode field is a one-character code; the Status mode is clearer.
+    QString modeName = it->mode;
+    if (modeName.isEmpty()) {
+        modeName = mode == "+" ? "FT4" : "FT8";
+    }
+    if ((modeName == "FT8" && !modeVisible[2]) || (modeName == "FT4" && !modeVisible[3])) {
+        return;
+    }
+
+    const QVector<AwardEngine::Slot> *slots = awards->lookup(caller);
+    if (!slots) {
+        return;     // not a target station
+    }
+
+    // Reply first: everything else can wait, the transmit window cannot.
+    // A Reply acts like a double-click in WSJT-X, so it is only sent while
+    // the instance is idle: not transmitting, Tx not enabled and no DX call
+    // set, or it would take over a QSO in progress between periods.
+    const bool rigIdle = !it->transmitting && !it->txEnabled && it->dxCall.isEmpty();
+    if (ui->autoReplyCheckBox->isChecked() && message.startsWith("CQ ") && rigIdle && !lowConfidence
+        && awards->isNeeded(*slots, band, modeName)) {
+        const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+        const qint64 lastMs = lastAutoReplyMs.value(caller, 0);
+        if (nowMs - lastMs >= kAutoReplyCooldownMs) {
+            const qint64 latencyUs = udp->sendReply(instanceId, time, snr, deltaTime, deltaFreq,
+                                                    mode, message, lowConfidence);
+            if (latencyUs >= 0) {
+                lastAutoReplyMs.insert(caller, nowMs);
+                qDebug().noquote() << "Auto-reply to" << caller << "via" << instanceId
+                                   << "in" << latencyUs << "us";
+                if (latencyUs > kAutoReplyBudgetUs) {
+                    qWarning() << "Auto-reply exceeded budget of" << kAutoReplyBudgetUs << "us";
+                }
+                if (statusInfoLabel) {
+                    statusInfoLabel->setText(QString("Calling %1 on %2m %3 (%4)")
+                                                 .arg(caller, band, modeName, instanceId));
+                }
+            }
+        }
+    }
+
+    recordSpot(SpotHistory::SourceWsjtx, caller, QString(), band,
+               quint32(it->dialFreqHz + deltaFreq), modeName, snr);
+    spotQueue.add(caller, band, modeName, quint32(it->dialFreqHz + deltaFreq), instanceId,
+                  QDateTime::currentMSecsSinceEpoch(), awards->pointGain(*slots, band, modeName));
+}
+
+void MainWindow::updateFilterStatus()
+{
+    if (!statusInfoLabel) {
+        return;
+    }
+    const FilterStats &f = rbnFilter;
+    statusInfoLabel->setToolTip(QString("RBN spots %1: off-band %2, no rig on band %3, mode off %4, "
+                                        "not a target %5, kept %6\nClick to pause or resume RBN")
+                                    .arg(f.spots).arg(f.offBand).arg(f.noRig).arg(f.modeOff)
+                                    .arg(f.notTarget).arg(f.passed));
+}
+
+void MainWindow::logIngestStats()
+{
+    const double seconds = qMax<qint64>(1, ingestClock.restart()) / 1000.0;
+    qInfo().noquote() << QString("Ingest: RBN %1 lines/s (%2 spots/s, %3 ms busy), "
+                                 "WSJT-X %4 decodes/s, latency avg %5 ms max %6 ms")
+                             .arg(ingest.rbnLines / seconds, 0, 'f', 1)
+                             .arg(ingest.rbnSpots / seconds, 0, 'f', 1)
+                             .arg(ingest.rbnBusyMs)
+                             .arg(ingest.decodes / seconds, 0, 'f', 1)
+                             .arg(ingest.decodes ? ingest.latencySumMs / ingest.decodes : 0)
+                             .arg(ingest.latencyMaxMs);
+    qInfo().noquote() << QString("RBN filter: %1 spots, dropped off-band %2, no rig %3, mode off %4, "
+                                 "not a target %5; kept %6")
+                             .arg(rbnFilter.spots).arg(rbnFilter.offBand).arg(rbnFilter.noRig)
+                             .arg(rbnFilter.modeOff).arg(rbnFilter.notTarget).arg(rbnFilter.passed);
+    ingest = IngestStats();
+}
+
+void MainWindow::recordSpot(quint8 source, const QString &call, const QString &skimmer, const QString &band,
+                            quint32 freqHz, const QString &mode, int snr)
+{
+    if (!spotHistory.isOpen()) {
+        return;
+    }
+
+    SpotRecord rec{};
+    rec.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    rec.callKey = callsigns.key(call);
+    rec.skimmerKey = callsigns.key(skimmer);
+    rec.freqHz = freqHz;
+    rec.snr = qint16(qBound(-128, snr, 127));
+    rec.band = quint8(band.toInt());
+    rec.mode = SpotHistory::modeFromString(mode);
+    rec.source = source;
+    spotHistory.append(rec);
+
+    activityStats.add(rec);
+    if (rec.callKey == heatMapCallKey && heatMap) {
+        heatMap->setCounts(call, activityStats.counts(rec.callKey));
+    }
+}
+
+void MainWindow::showLastHeard(int row)
+{
+    if (!m_model || row < 0 || !statusInfoLabel) {
+        return;
+    }
+
+    const QString call = m_model->data(m_model->index(row, m_model->fieldIndex("callsign"))).toString().trimmed().toUpper();
+    const quint32 key = callsigns.key(call, false);
+    if (key == 0) {
+        statusInfoLabel->setText(QString("%1 not heard yet").arg(call));
+        return;
+    }
+
+    QStringList parts;
+    for (const QString &band : awards->award(currentAward).bands) {
+        const SpotRecord *rec = spotHistory.lastSeen(key, quint8(band.toInt()));
+        if (!rec) {
+            continue;
+        }
+        parts << QString("%1m %2 %3")
+                     .arg(band)
+                     .arg(SpotHistory::modeName(rec->mode))
+                     .arg(QDateTime::fromMSecsSinceEpoch(rec->timestampMs, Qt::UTC).toString("yyyy-MM-dd HH:mm"));
+    }
+
+    // Recent activity: a range scan over the last day only, started through
+    // the hour index.
+    const qint64 since = QDateTime::currentMSecsSinceEpoch() - 24 * 3600 * 1000;
+    int recent = 0;
+    spotHistory.scanIndices(spotHistory.firstIndexAtOrAfter(since), spotHistory.count(),
+                            [key, &recent](const SpotRecord &rec) {
+        if (rec.callKey == key) {
+            ++recent;
+        }
+        return true;
+    });
+
+    statusInfoLabel->setText(parts.isEmpty()
+                                 ? QString("%1 not heard yet").arg(call)
+                                 : QString("%1 last heard: %2 (%3 spots in 24 h)")
+                                       .arg(call, parts.join(", "))
+                                       .arg(recent));
+}
+
+void MainWindow::showActivity(int row)
+{
+    if (!m_model || !heatMap) {
+        return;
+    }
+
+    const QString call = row < 0 ? QString()
+        : m_model->data(m_model->index(row, m_model->fieldIndex("callsign"))).toString().trimmed().toUpper();
+    heatMapCallKey = callsigns.key(call, false);
+    heatMap->setCounts(call, heatMapCallKey ? activityStats.counts(heatMapCallKey) : nullptr);
+}
+
+void MainWindow::showAward(int award)
+{
+    const AwardDefinition &def = awards->award(award);
+    currentAward = award;
+
+    // Drop delegates set for the previous award's band columns.
+    for (int col = 0; col < m_model->columnCount(); ++col) {
+        ui->tableView->setItemDelegateForColumn(col, nullptr);
+    }
+
+    m_model->setTable(def.table);
+    const int callCol = m_model->fieldIndex("callsign");
+    if (callCol >= 0) {
+        m_model->setSort(callCol, Qt::AscendingOrder);
+    }
+    m_model->select();
+
+    ui->tableView->setColumnHidden(m_model->fieldIndex("id"), true);
+
+    QStringList modeNames;
+    for (const AwardMode &mode : def.modes) {
+        modeNames << mode.name;
+    }
+    checkboxDelegate->setModes(modeNames);
+
+    // ✅ Use the custom delegate on the band columns
+    for (const QString &band : def.bands) {
+        const int col = m_model->fieldIndex(band);
+        if (col < 0) {
+            continue;
+        }
+        ui->tableView->setItemDelegateForColumn(col, checkboxDelegate);
+        ui->tableView->setColumnWidth(col, 30 * qMax(4, int(def.modes.size())));
+    }
+}
+
+void MainWindow::syncAwardCells(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    const AwardDefinition &def = awards->award(currentAward);
+    const QSqlRecord record = m_model->record();
+    const int idCol = m_model->fieldIndex("id");
+
+    for (int col = topLeft.column(); col <= bottomRight.column(); ++col) {
+        if (col == m_model->fieldIndex("callsign")) {
+            // A renamed or newly named target changes the callsign index.
+            awards->reloadAward(currentAward);
+            return;
+        }
+
+        const int band = def.bands.indexOf(record.fieldName(col));
+        if (band < 0) {
+            continue;
+        }
+        for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+            const qint64 id = m_model->data(m_model->index(row, idCol)).toLongLong();
+            awards->setMask(currentAward, id, band, m_model->data(m_model->index(row, col)).toInt());
+            spotQueue.refreshCall(m_model->data(m_model->index(row, m_model->fieldIndex("callsign")))
+                                      .toString().trimmed().toUpper());
+        }
+    }
+}
+
+void MainWindow::refreshSpotTable()
+{
+    // Only the visible top of the queue is copied out.
+    static constexpr int kVisibleSpots = 50;
+    const QVector<SpotQueue::Entry> spots = spotQueue.top(kVisibleSpots);
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    QTableWidget *table = ui->spotTable;
+    table->setRowCount(spots.size());
+    for (int row = 0; row < spots.size(); ++row) {
+        const SpotQueue::Entry &e = spots[row];
+        const QStringList cells = {
+            e.call,
+            e.band + "m",
+            e.mode,
+            QString::number(e.freqHz / 1000.0, 'f', 1),
+            QString::number(e.gain),
+            QString::number(e.spotters.size()),
+            QString("%1 min").arg((now - e.lastSeenMs) / 60000),
+        };
+        for (int col = 0; col < cells.size(); ++col) {
+            QTableWidgetItem *item = table->item(row, col);
+            if (!item) {
+                item = new QTableWidgetItem;
+                table->setItem(row, col, item);
+            }
+            item->setText(cells[col]);
+        }
+    }
+}
@@ -1,11 +1,21 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include "activitystats.h"
+#include "appconfig.h"
+#include "awardengine.h"
+#include "callsigntable.h"
+#include "spothistory.h"
+#include "spotqueue.h"
 #include "udpreceiver.h"
 #include <QMainWindow>
+#include <QComboBox>
+#include <QElapsedTimer>
 #include <QLabel>
+#include <QPair>
 #include <QSqlTableModel>
 #include <QTcpSocket>
+#include <QTimer>
 #include <array>
 
 QT_BEGIN_NAMESPACE
@@ -15,18 +25,26 @@ class MainWindow;
 QT_END_NAMESPACE
 
 class CheckboxDelegate;
+class QFileSystemWatcher;
+class HeatMapWidget;
+class StateServer;
+class QThread;
 
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
 
 public:
-    MainWindow(QWidget *parent = nullptr);
+    MainWindow(const AppConfig &config, AwardEngine *awards, QWidget *parent = nullptr);
     ~MainWindow();
 public slots:
-    void onQsoLogged(const QString &call, const QString &band, const QString &mode);
+    void onQsoLogged(const QString &instanceId, const QString &call, const QString &band, const QString &mode);
     void onAddClicked();
     void onClearClicked();
+    void onExportClicked();
+    void reconcileAwards();
+    void onDecoded(const QString &instanceId, const QTime &time, int snr, double deltaTime, quint32 deltaFreq,
+                   const QString &mode, const QString &message, bool lowConfidence);
 protected:
     bool eventFilter(QObject *obj, QEvent *event) override;
 private:
@@ -34,15 +52,82 @@ private:
     UdpReceiver *udp = nullptr;
     void updateStatusCounts();
     void updateModeVisibility();
+    void updateInstanceStatus();
+    void recordSpot(quint8 source, const QString &call, const QString &skimmer, const QString &band,
+                    quint32 freqHz, const QString &mode, int snr);
+    void showLastHeard(int row);
+    void showActivity(int row);
+    void showAward(int award);
+    void syncAwardCells(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void setRbnPaused(bool paused);
+    void connectRbn();
+    void scheduleRbnReconnect();
+    void onRbnReadyRead();
+    void drainRbn();
+    void refreshSpotTable();
+    void logIngestStats();
+    void updateFilterStatus();
+    void syncTargetLists();
 
     QLabel *statusInfoLabel = nullptr;
     QLabel *statusCountsLabel = nullptr;
+    QLabel *statusRigsLabel = nullptr;
     QSqlTableModel *m_model = nullptr;
+    AwardEngine *awards = nullptr;
+    QString snapshotFile;
+    int currentAward = 0;
+    QComboBox *awardCombo = nullptr;
     class CheckboxDelegate *checkboxDelegate = nullptr;
     std::array<bool, 4> modeVisible{{true, true, true, true}};
     QTcpSocket *rbnSocket = nullptr;
+    QString rbnHost;
+    quint16 rbnPort = 7000;
+    QTimer *rbnReconnectTimer = nullptr;
+    int rbnReconnectMs = 5000;      // next reconnect delay
     QByteArray rbnBuffer;
     bool rbnLoginSent = false;
     bool rbnOutputPaused = false;
+    QByteArray rbnCall;
+    // Counters for --measure-latency, reset each time they are logged.
+    struct IngestStats {
+        qint64 rbnLines = 0;
+        qint64 rbnSpots = 0;        // lines on a tracked band for a target station
+        qint64 rbnBusyMs = 0;       // time spent parsing RBN lines
+        qint64 decodes = 0;
+        qint64 latencySumMs = 0;
+        qint64 latencyMaxMs = 0;
+    };
+    bool measureLatency = false;
+    IngestStats ingest;
+    // RBN lines dropped per filter stage, since start.
+    struct FilterStats {
+        qint64 spots = 0;           // lines that parsed as spots
+        qint64 offBand = 0;         // band not in any award
+        qint64 noRig = 0;           // no WSJT-X instance on the band in that mode
+        qint64 modeOff = 0;         // mode unchecked in the UI
+        qint64 notTarget = 0;       // callsign lookup missed
+        qint64 passed = 0;
+    };
+    FilterStats rbnFilter;
+    QSet<QString> trackedBands;     // bands of every award
+    // (band, mode checkbox index) of every WSJT-X instance. A spot is only
+    // held to this when some instance runs its mode, so CW and phone spots
+    // pass while all rigs are on FT8.
+    QSet<QPair<QString, int>> rigBandModes;
+    std::array<bool, 4> rigModes{};
+    QElapsedTimer ingestClock;
+    CallsignTable callsigns;
+    SpotHistory spotHistory;
+    ActivityStats activityStats;
+    HeatMapWidget *heatMap = nullptr;
+    quint32 heatMapCallKey = 0;
+    SpotQueue spotQueue;
+    QTimer *spotQueueTimer = nullptr;
+    QFileSystemWatcher *targetWatcher = nullptr;
+    QTimer *targetSyncTimer = nullptr;
+    QHash<QString, qint64> lastAutoReplyMs;     // per station, for the cooldown
+    StateServer *stateServer = nullptr;
+    QThread *reconcileThread = nullptr;
+    bool targetSyncPending = false;     // held back until the reconcile read the target lists
 };
 #endif // MAINWINDOW_H
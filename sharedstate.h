@@ -0,0 +1,145 @@
+#ifndef SHAREDSTATE_H
+#define SHAREDSTATE_H
+
+// Layout of WWA.state, the award state WWA publishes for other local tools.
+//
+// The file is memory-mapped by WWA and by readers (mmap MAP_SHARED, read-only
+// for readers), so lookups need no copy and never touch WWA.db. This header
+// has no Qt dependency and may be copied into other projects.
+//
+// Concurrency is a seqlock: WWA makes `sequence` odd, rewrites the payload,
+// then makes it even again. A reader copies what it needs between two reads
+// of `sequence` and retries if they differ or are odd; readLookup() below
+// does exactly that, yielding between attempts and giving up after a bound.
+//
+// When the state outgrows the file, WWA writes a new file and sets `retired`
+// in the old one; readers that see it should unmap and reopen.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+namespace SharedState {
+
+constexpr char kMagic[8] = {'W', 'W', 'A', 'S', 'T', 'A', 'T', 'E'};
+constexpr uint32_t kVersion = 1;
+constexpr int kMaxBands = 16;
+constexpr int kMaxModes = 8;
+constexpr int kCallBytes = 16;      // NUL-padded; longer callsigns are not published
+constexpr int kReadAttempts = 1000; // readLookup() gives up after this many torn reads
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;            // sizeof(Header)
+    std::atomic<uint32_t> sequence; // odd while WWA is writing
+    uint32_t retired;               // non-zero: file replaced, reopen it
+    uint32_t awardCount;
+    uint32_t reserved0;
+    uint64_t capacity;              // file size
+    uint64_t payloadSize;           // bytes in use after the header
+    uint64_t generation;            // changes whenever the award state does
+    uint64_t reserved1;
+};
+
+// One per award, each followed by `rows` Entry records sorted by call
+// (strcmp order), so a reader can binary-search them in place.
+struct Award {
+    char name[32];
+    uint32_t rows;
+    uint32_t bandCount;
+    uint32_t modeCount;
+    uint32_t reserved;
+    char bands[kMaxBands][4];       // "160", "80", ... "10"
+    char modes[kMaxModes][8];       // "CW", "PH", "FT8", ...
+    uint8_t points[kMaxModes];
+};
+
+struct Entry {
+    char call[kCallBytes];
+    uint8_t masks[kMaxBands];       // per band: bit i set = modes[i] worked
+};
+
+static_assert(sizeof(Header) == 64, "Header layout");
+static_assert(sizeof(Award) == 184, "Award layout");
+static_assert(sizeof(Entry) == 32, "Entry layout");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "sequence must be lock-free");
+
+inline const Entry *findEntry(const Award *award, const char *call)
+{
+    const Entry *entries = reinterpret_cast<const Entry *>(award + 1);
+    size_t lo = 0;
+    size_t hi = award->rows;
+    while (lo < hi) {
+        const size_t mid = (lo + hi) / 2;
+        const int cmp = std::strncmp(entries[mid].call, call, kCallBytes);
+        if (cmp == 0) {
+            return &entries[mid];
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return nullptr;
+}
+
+// Copies the band masks of `call` (upper-case) in award number `award` into
+// `masks`. Returns 1 if found, 0 if not a target, -1 if the mapping is not
+// a valid state file or has been retired, and -2 if every attempt met a
+// write in progress. A publish takes microseconds, so -2 means WWA stopped
+// mid-write (e.g. crashed); try again later rather than spinning.
+inline int readLookup(const void *base, size_t size, uint32_t award, const char *call,
+                      uint8_t masks[kMaxBands])
+{
+    const Header *header = static_cast<const Header *>(base);
+    if (size < sizeof(Header) || std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0
+        || header->version != kVersion) {
+        return -1;
+    }
+
+    for (int attempt = 0; attempt < kReadAttempts; ++attempt) {
+        if (attempt > 0) {
+            std::this_thread::yield();
+        }
+        const uint32_t before = header->sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+
+        int found = 0;
+        if (header->retired) {
+            return -1;
+        }
+        const char *p = static_cast<const char *>(base) + header->headerSize;
+        const char *end = static_cast<const char *>(base) + size;
+        for (uint32_t i = 0; i < header->awardCount && p + sizeof(Award) <= end; ++i) {
+            const Award *a = reinterpret_cast<const Award *>(p);
+            const char *next = p + sizeof(Award) + size_t(a->rows) * sizeof(Entry);
+            if (next > end) {
+                break;      // torn read; the sequence check below catches it
+            }
+            if (i == award) {
+                if (const Entry *e = findEntry(a, call)) {
+                    std::memcpy(masks, e->masks, kMaxBands);
+                    found = 1;
+                }
+                break;
+            }
+            p = next;
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header->sequence.load(std::memory_order_relaxed) == before) {
+            return found;
+        }
+    }
+    return -2;
+}
+
+} // namespace SharedState
+
+#endif // SHAREDSTATE_H
@@ -0,0 +1,328 @@
+#include "spothistory.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+const char kMagic[8] = {'W', 'W', 'A', 'S', 'P', 'O', 'T', 'S'};
+constexpr quint32 kVersion = 1;
+}
+
+struct SpotHistory::Header {
+    char magic[8];
+    quint32 version;
+    quint32 recordSize;
+    quint64 count;
+};
+
+SpotHistory::~SpotHistory()
+{
+    close();
+}
+
+bool SpotHistory::open(const QString &path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Cannot open spot history" << path << "-" << m_file.errorString();
+        return false;
+    }
+
+    const bool fresh = m_file.size() < kHeaderSize;
+    if (fresh && !m_file.resize(kHeaderSize)) {
+        qWarning() << "Cannot initialize spot history:" << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    m_header = reinterpret_cast<Header *>(m_file.map(0, kHeaderSize));
+    if (!m_header) {
+        qWarning() << "Cannot map spot history header:" << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    if (fresh) {
+        std::memcpy(m_header->magic, kMagic, sizeof(kMagic));
+        m_header->version = kVersion;
+        m_header->recordSize = sizeof(SpotRecord);
+        m_header->count = 0;
+    } else if (std::memcmp(m_header->magic, kMagic, sizeof(kMagic)) != 0
+               || m_header->version != kVersion
+               || m_header->recordSize != sizeof(SpotRecord)) {
+        qWarning() << "Spot history" << path << "has an unknown format, not using it";
+        close();
+        return false;
+    }
+
+    // Never trust a count beyond what the file actually holds.
+    const quint64 capacity = quint64(m_file.size() - kHeaderSize) / sizeof(SpotRecord);
+    if (m_header->count > capacity) {
+        qWarning() << "Spot history count" << m_header->count << "exceeds file size, truncating to" << capacity;
+        m_header->count = capacity;
+    }
+
+    const int segments = int((m_header->count + kRecordsPerSegment - 1) / kRecordsPerSegment);
+    for (int seg = 0; seg < segments; ++seg) {
+        if (!mapSegment(seg)) {
+            close();
+            return false;
+        }
+    }
+
+    m_indexFile.setFileName(path + ".idx");
+    if (!loadIndex()) {
+        rebuildIndex();
+    }
+
+    qDebug() << "Spot history:" << m_header->count << "records," << m_hours.size() << "hours indexed";
+    return true;
+}
+
+void SpotHistory::close()
+{
+    m_segments.clear();
+    m_hours.clear();
+    m_lastSeen.clear();
+    m_lastSeenBuilt = false;
+    m_header = nullptr;
+    if (m_file.isOpen()) {
+        m_file.close();     // also unmaps everything mapped through it
+    }
+    if (m_indexFile.isOpen()) {
+        m_indexFile.close();
+    }
+}
+
+bool SpotHistory::mapSegment(int segment)
+{
+    const qint64 bytes = qint64(kRecordsPerSegment * sizeof(SpotRecord));
+    const qint64 offset = kHeaderSize + segment * bytes;
+
+    if (m_file.size() < offset + bytes) {
+        // Some platforms cannot grow a file that has live mappings, so drop
+        // them, grow, and map everything again. This happens once per segment.
+        // QFile::close() releases every mapping made through it.
+        const int mapped = m_segments.size();
+        m_segments.clear();
+        m_header = nullptr;
+        const QString path = m_file.fileName();
+        m_file.close();
+        m_file.setFileName(path);
+        if (!m_file.open(QIODevice::ReadWrite) || !m_file.resize(offset + bytes)) {
+            qWarning() << "Cannot grow spot history:" << m_file.errorString();
+            return false;
+        }
+        m_header = reinterpret_cast<Header *>(m_file.map(0, kHeaderSize));
+        if (!m_header) {
+            qWarning() << "Cannot map spot history header:" << m_file.errorString();
+            return false;
+        }
+        for (int seg = 0; seg < mapped; ++seg) {
+            uchar *p = m_file.map(kHeaderSize + seg * bytes, bytes);
+            if (!p) {
+                qWarning() << "Cannot map spot history segment" << seg << "-" << m_file.errorString();
+                return false;
+            }
+            m_segments.append(reinterpret_cast<SpotRecord *>(p));
+        }
+    }
+
+    uchar *p = m_file.map(offset, bytes);
+    if (!p) {
+        qWarning() << "Cannot map spot history segment" << segment << "-" << m_file.errorString();
+        return false;
+    }
+    m_segments.append(reinterpret_cast<SpotRecord *>(p));
+    return true;
+}
+
+bool SpotHistory::loadIndex()
+{
+    if (!m_indexFile.open(QIODevice::ReadWrite)) {
+        qWarning() << "Cannot open spot history index:" << m_indexFile.errorString();
+        return false;
+    }
+
+    const qint64 size = m_indexFile.size();
+    if (size % qint64(sizeof(HourIndex)) != 0) {
+        return false;
+    }
+
+    m_hours.resize(int(size / qint64(sizeof(HourIndex))));
+    if (size > 0 && m_indexFile.read(reinterpret_cast<char *>(m_hours.data()), size) != size) {
+        return false;
+    }
+
+    // The index is written after the record it points at, so it may lag
+    // behind the data file but never run ahead of it.
+    const quint64 n = count();
+    for (int i = 0; i < m_hours.size(); ++i) {
+        const HourIndex &h = m_hours[i];
+        if (h.firstIndex >= n || (i > 0 && (h.hour <= m_hours[i - 1].hour
+                                            || h.firstIndex <= m_hours[i - 1].firstIndex))) {
+            return false;
+        }
+        if (at(h.firstIndex).timestampMs / kHourMs != h.hour) {
+            return false;
+        }
+    }
+
+    const qint64 lastHour = m_hours.isEmpty() ? -1 : m_hours.last().hour;
+    if (n > 0 && at(n - 1).timestampMs / kHourMs != lastHour) {
+        return false;
+    }
+    m_indexFile.seek(size);
+    return true;
+}
+
+void SpotHistory::rebuildIndex()
+{
+    m_hours.clear();
+    qint64 hour = -1;
+    const quint64 n = count();
+    for (quint64 i = 0; i < n; ++i) {
+        const qint64 h = at(i).timestampMs / kHourMs;
+        if (h != hour) {
+            m_hours.append(HourIndex{h, i});
+            hour = h;
+        }
+    }
+
+    if (m_indexFile.isOpen()) {
+        m_indexFile.close();
+    }
+    if (!m_indexFile.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        qWarning() << "Cannot write spot history index:" << m_indexFile.errorString();
+        return;
+    }
+    m_indexFile.write(reinterpret_cast<const char *>(m_hours.constData()),
+                      qint64(m_hours.size()) * qint64(sizeof(HourIndex)));
+    m_indexFile.flush();
+    qDebug() << "Spot history index rebuilt:" << m_hours.size() << "hours";
+}
+
+quint64 SpotHistory::count() const
+{
+    return m_header ? m_header->count : 0;
+}
+
+const SpotRecord &SpotHistory::at(quint64 index) const
+{
+    return m_segments[int(index / kRecordsPerSegment)][index % kRecordsPerSegment];
+}
+
+bool SpotHistory::append(const SpotRecord &record)
+{
+    if (!isOpen()) {
+        return false;
+    }
+
+    const quint64 n = count();
+    const quint64 seg = n / kRecordsPerSegment;
+    if (seg >= quint64(m_segments.size()) && !mapSegment(int(seg))) {
+        return false;
+    }
+
+    SpotRecord &slot = m_segments[int(seg)][n % kRecordsPerSegment];
+    slot = record;
+    if (n > 0 && slot.timestampMs < at(n - 1).timestampMs) {
+        slot.timestampMs = at(n - 1).timestampMs;
+    }
+    std::memset(slot.reserved, 0, sizeof(slot.reserved));
+    m_header->count = n + 1;
+    if (m_lastSeenBuilt) {
+        m_lastSeen.insert(lastSeenKey(slot.callKey, slot.band), n);
+    }
+
+    const qint64 hour = slot.timestampMs / kHourMs;
+    if (m_hours.isEmpty() || m_hours.last().hour != hour) {
+        const HourIndex h{hour, n};
+        m_hours.append(h);
+        if (m_indexFile.isOpen()) {
+            m_indexFile.write(reinterpret_cast<const char *>(&h), sizeof(h));
+            m_indexFile.flush();
+        }
+    }
+    return true;
+}
+
+quint64 SpotHistory::firstIndexAtOrAfter(qint64 timestampMs) const
+{
+    const quint64 n = count();
+    if (n == 0) {
+        return 0;
+    }
+
+    // Narrow down to one hour with the index, then binary search inside it.
+    const qint64 hour = timestampMs / kHourMs;
+    const auto next = std::upper_bound(m_hours.cbegin(), m_hours.cend(), hour,
+                                       [](qint64 h, const HourIndex &e) { return h < e.hour; });
+    quint64 lo = next == m_hours.cbegin() ? 0 : (next - 1)->firstIndex;
+    quint64 hi = next == m_hours.cend() ? n : next->firstIndex;
+
+    while (lo < hi) {
+        const quint64 mid = lo + (hi - lo) / 2;
+        if (at(mid).timestampMs < timestampMs) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void SpotHistory::buildLastSeen() const
+{
+    QElapsedTimer timer;
+    timer.start();
+    m_lastSeen.clear();
+    quint64 index = 0;
+    scanIndices(0, count(), [&](const SpotRecord &rec) {
+        m_lastSeen.insert(lastSeenKey(rec.callKey, rec.band), index++);
+        return true;
+    });
+    m_lastSeenBuilt = true;
+    qDebug() << "Spot history last-seen table:" << m_lastSeen.size() << "entries in" << timer.elapsed() << "ms";
+}
+
+const SpotRecord *SpotHistory::lastSeen(quint32 callKey, quint8 band) const
+{
+    if (!isOpen()) {
+        return nullptr;
+    }
+    if (!m_lastSeenBuilt) {
+        buildLastSeen();
+    }
+    const auto it = m_lastSeen.constFind(lastSeenKey(callKey, band));
+    return it == m_lastSeen.constEnd() ? nullptr : &at(it.value());
+}
+
+quint8 SpotHistory::modeFromString(const QString &mode)
+{
+    const QString m = mode.trimmed().toUpper();
+    if (m == "CW") return ModeCW;
+    if (m == "PH" || m == "SSB" || m == "USB" || m == "LSB" || m == "AM" || m == "FM") return ModePH;
+    if (m == "FT8") return ModeFT8;
+    if (m == "FT4") return ModeFT4;
+    if (m == "RTTY") return ModeRTTY;
+    if (m.isEmpty()) return ModeUnknown;
+    return ModeOther;
+}
+
+QString SpotHistory::modeName(quint8 mode)
+{
+    switch (mode) {
+    case ModeCW:   return "CW";
+    case ModePH:   return "PH";
+    case ModeFT8:  return "FT8";
+    case ModeFT4:  return "FT4";
+    case ModeRTTY: return "RTTY";
+    case ModeOther: return "other";
+    default:       return QString();
+    }
+}
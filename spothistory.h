@@ -0,0 +1,107 @@
+#ifndef SPOTHISTORY_H
+#define SPOTHISTORY_H
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+// One spot, stored as a fixed 32-byte record.
+struct SpotRecord {
+    qint64 timestampMs;     // UTC, ms since epoch; non-decreasing in the file
+    quint32 callKey;        // CallsignTable key of the spotted station
+    quint32 skimmerKey;     // CallsignTable key of the skimmer, 0 for decodes
+    quint32 freqHz;
+    qint16 snr;             // dB
+    quint8 band;            // band in meters (10, 12, ... 160), 0 if unknown
+    quint8 mode;            // SpotHistory::Mode
+    quint8 source;          // SpotHistory::Source
+    quint8 reserved[7];
+};
+static_assert(sizeof(SpotRecord) == 32, "SpotRecord must stay 32 bytes");
+
+// Append-only spot history in a memory-mapped file.
+//
+// The file is a 4 KiB header followed by records. It grows in fixed-size
+// segments that are mapped one by one, so the history is never copied to
+// the heap and scans run straight over the page cache. A sidecar ".idx"
+// file holds the first record of every UTC hour, which lets range scans
+// start at the right place without touching older records.
+class SpotHistory
+{
+public:
+    enum Mode : quint8 { ModeUnknown = 0, ModeCW, ModePH, ModeFT8, ModeFT4, ModeRTTY, ModeOther };
+    enum Source : quint8 { SourceUnknown = 0, SourceRbn, SourceWsjtx };
+
+    SpotHistory() = default;
+    ~SpotHistory();
+    SpotHistory(const SpotHistory &) = delete;
+    SpotHistory &operator=(const SpotHistory &) = delete;
+
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+
+    // Timestamps earlier than the last stored one are clamped to it so that
+    // the file stays sorted by time.
+    bool append(const SpotRecord &record);
+
+    quint64 count() const;
+    const SpotRecord &at(quint64 index) const;
+
+    static quint8 modeFromString(const QString &mode);
+    static QString modeName(quint8 mode);
+
+    // Index of the first record at or after `timestampMs`, found through the
+    // hour index; for range scans with scanIndices().
+    quint64 firstIndexAtOrAfter(qint64 timestampMs) const;
+
+    // Newest record for a station on a band (meters), or nullptr. The table
+    // behind it is built with one pass over the history on first use and
+    // kept current by append(), so later lookups do not scan.
+    const SpotRecord *lastSeen(quint32 callKey, quint8 band) const;
+
+    // Calls fn(const SpotRecord &) for records [begin, end), oldest first.
+    template <typename Fn>
+    void scanIndices(quint64 begin, quint64 end, Fn &&fn) const
+    {
+        end = qMin(end, count());
+        for (quint64 i = begin; i < end;) {
+            const quint64 seg = i / kRecordsPerSegment;
+            const SpotRecord *rec = m_segments[int(seg)] + (i % kRecordsPerSegment);
+            const quint64 segEnd = qMin(end, (seg + 1) * kRecordsPerSegment);
+            for (; i < segEnd; ++i, ++rec) {
+                if (!fn(*rec)) {
+                    return;
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr qint64 kHeaderSize = 4096;
+    static constexpr quint64 kRecordsPerSegment = 1u << 18;     // 8 MiB per mapping
+    static constexpr qint64 kHourMs = 3600 * 1000;
+
+    struct Header;
+    struct HourIndex {
+        qint64 hour;            // timestampMs / kHourMs
+        quint64 firstIndex;
+    };
+
+    bool mapSegment(int segment);
+    bool loadIndex();
+    void rebuildIndex();
+    void buildLastSeen() const;
+    static quint64 lastSeenKey(quint32 callKey, quint8 band) { return (quint64(callKey) << 8) | band; }
+
+    QFile m_file;
+    QFile m_indexFile;
+    Header *m_header = nullptr;
+    QVector<SpotRecord *> m_segments;
+    QVector<HourIndex> m_hours;
+    mutable QHash<quint64, quint64> m_lastSeen;     // lastSeenKey() -> record index
+    mutable bool m_lastSeenBuilt = false;
+};
+
+#endif // SPOTHISTORY_H
@@ -0,0 +1,164 @@
+#include "spotqueue.h"
+#include "awardengine.h"
+
+namespace {
+QString slotKey(const QString &call, const QString &band, const QString &mode)
+{
+    return call + QLatin1Char('|') + band + QLatin1Char('|') + mode;
+}
+}
+
+bool SpotQueue::Rank::operator<(const Rank &o) const
+{
+    if (gain != o.gain) return gain > o.gain;
+    if (minute != o.minute) return minute > o.minute;
+    if (spotters != o.spotters) return spotters > o.spotters;
+    if (lastSeenMs != o.lastSeenMs) return lastSeenMs > o.lastSeenMs;
+    return id < o.id;
+}
+
+SpotQueue::SpotQueue(const AwardEngine *awards, qint64 ttlMs)
+    : m_awards(awards)
+    , m_ttlMs(ttlMs)
+{
+}
+
+SpotQueue::Rank SpotQueue::rankOf(quint64 id, const Entry &e) const
+{
+    return Rank{e.gain, e.lastSeenMs / 60000, int(e.spotters.size()), e.lastSeenMs, id};
+}
+
+void SpotQueue::insertRanks(quint64 id, const Entry &e)
+{
+    m_ranked.insert(rankOf(id, e));
+    m_byAge.insert({e.lastSeenMs, id});
+}
+
+void SpotQueue::eraseRanks(quint64 id, const Entry &e)
+{
+    m_ranked.erase(rankOf(id, e));
+    m_byAge.erase({e.lastSeenMs, id});
+}
+
+void SpotQueue::add(const QString &call, const QString &band, const QString &mode, quint32 freqHz,
+                    const QString &spotter, qint64 nowMs, int gain)
+{
+    const QString m = AwardEngine::normalizeMode(mode);
+    const QString key = slotKey(call, band, m);
+    if (gain < 0) {
+        gain = m_awards->pointGain(call, band, m);
+    }
+
+    const auto slot = m_bySlot.constFind(key);
+    if (slot == m_bySlot.constEnd()) {
+        if (gain <= 0) {
+            return;
+        }
+        const quint64 id = m_nextId++;
+        Entry e;
+        e.call = call;
+        e.band = band;
+        e.mode = m;
+        e.freqHz = freqHz;
+        e.gain = gain;
+        e.firstSeenMs = nowMs;
+        e.lastSeenMs = nowMs;
+        if (!spotter.isEmpty()) {
+            e.spotters.insert(spotter);
+        }
+        m_entries.insert(id, e);
+        m_bySlot.insert(key, id);
+        m_byCall[call].insert(id);
+        insertRanks(id, e);
+        return;
+    }
+
+    const quint64 id = slot.value();
+    if (gain <= 0) {
+        remove(id);
+        return;
+    }
+
+    Entry &e = m_entries[id];
+    eraseRanks(id, e);
+    e.freqHz = freqHz;
+    e.gain = gain;
+    e.lastSeenMs = qMax(e.lastSeenMs, nowMs);
+    if (!spotter.isEmpty()) {
+        e.spotters.insert(spotter);
+    }
+    insertRanks(id, e);
+}
+
+void SpotQueue::refreshCall(const QString &call)
+{
+    const auto it = m_byCall.constFind(call);
+    if (it == m_byCall.constEnd()) {
+        return;
+    }
+
+    const QSet<quint64> ids = it.value();   // remove() edits m_byCall
+    for (quint64 id : ids) {
+        rescore(id);
+    }
+}
+
+void SpotQueue::refreshAll()
+{
+    const QList<quint64> ids = m_entries.keys();
+    for (quint64 id : ids) {
+        rescore(id);
+    }
+}
+
+void SpotQueue::rescore(quint64 id)
+{
+    Entry &e = m_entries[id];
+    const int gain = m_awards->pointGain(e.call, e.band, e.mode);
+    if (gain <= 0) {
+        remove(id);
+        return;
+    }
+    if (gain != e.gain) {
+        eraseRanks(id, e);
+        e.gain = gain;
+        insertRanks(id, e);
+    }
+}
+
+void SpotQueue::expire(qint64 nowMs)
+{
+    while (!m_byAge.empty() && m_byAge.begin()->first < nowMs - m_ttlMs) {
+        remove(m_byAge.begin()->second);
+    }
+}
+
+QVector<SpotQueue::Entry> SpotQueue::top(int limit) const
+{
+    QVector<Entry> out;
+    out.reserve(qMin(limit, int(m_ranked.size())));
+    for (auto it = m_ranked.cbegin(); it != m_ranked.cend() && out.size() < limit; ++it) {
+        out.append(m_entries.value(it->id));
+    }
+    return out;
+}
+
+void SpotQueue::remove(quint64 id)
+{
+    const auto it = m_entries.find(id);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    const Entry &e = it.value();
+    eraseRanks(id, e);
+    m_bySlot.remove(slotKey(e.call, e.band, e.mode));
+    auto callIt = m_byCall.find(e.call);
+    if (callIt != m_byCall.end()) {
+        callIt->remove(id);
+        if (callIt->isEmpty()) {
+            m_byCall.erase(callIt);
+        }
+    }
+    m_entries.erase(it);
+}
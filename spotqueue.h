@@ -0,0 +1,83 @@
+#ifndef SPOTQUEUE_H
+#define SPOTQUEUE_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+#include <set>
+#include <utility>
+
+class AwardEngine;
+
+// Live ranking of needed spots.
+//
+// Each (call, band, mode) slot that would add award points is kept once and
+// ordered by point gain, then by the minute it was last spotted, then by the
+// number of distinct spotters. Inserts, updates and expiry are O(log n).
+class SpotQueue
+{
+public:
+    struct Entry {
+        QString call;
+        QString band;
+        QString mode;
+        quint32 freqHz = 0;
+        int gain = 0;
+        qint64 firstSeenMs = 0;
+        qint64 lastSeenMs = 0;
+        QSet<QString> spotters;     // skimmers or WSJT-X instances
+    };
+
+    explicit SpotQueue(const AwardEngine *awards, qint64 ttlMs = 10 * 60 * 1000);
+
+    // Adds or refreshes a spot. Spots that gain nothing are dropped (and an
+    // existing entry for the slot is removed). A caller that already has the
+    // award rows for `call` passes their point gain; otherwise (-1) it is
+    // looked up here.
+    void add(const QString &call, const QString &band, const QString &mode, quint32 freqHz,
+             const QString &spotter, qint64 nowMs, int gain = -1);
+
+    // Recomputes the gain of every entry for `call`, e.g. after a QSO.
+    void refreshCall(const QString &call);
+
+    // Recomputes every entry, after changes that touch many calls at once
+    // (clearing an award, reloading state or target lists).
+    void refreshAll();
+
+    // Drops entries not spotted within the TTL.
+    void expire(qint64 nowMs);
+
+    // Best first, at most `limit` entries.
+    QVector<Entry> top(int limit) const;
+
+    int size() const { return m_entries.size(); }
+
+private:
+    // Larger sorts first.
+    struct Rank {
+        int gain;
+        qint64 minute;
+        int spotters;
+        qint64 lastSeenMs;
+        quint64 id;
+        bool operator<(const Rank &o) const;
+    };
+
+    Rank rankOf(quint64 id, const Entry &e) const;
+    void insertRanks(quint64 id, const Entry &e);
+    void eraseRanks(quint64 id, const Entry &e);
+    void remove(quint64 id);
+    void rescore(quint64 id);
+
+    const AwardEngine *m_awards;
+    qint64 m_ttlMs;
+    quint64 m_nextId = 1;
+    QHash<quint64, Entry> m_entries;
+    QHash<QString, quint64> m_bySlot;           // "CALL|band|MODE" -> id
+    QHash<QString, QSet<quint64>> m_byCall;
+    std::set<Rank> m_ranked;
+    std::set<std::pair<qint64, quint64>> m_byAge;  // (lastSeenMs, id)
+};
+
+#endif // SPOTQUEUE_H
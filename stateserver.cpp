@@ -0,0 +1,248 @@
+#include "stateserver.h"
+#include "awardengine.h"
+#include "sharedstate.h"
+
+#include <QByteArrayList>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QMap>
+#include <QDebug>
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+constexpr int kPollMs = 200;
+constexpr quint64 kMinCapacity = 64 * 1024;
+constexpr qint64 kMaxRequestBytes = 1024;
+
+void copyName(char *dst, size_t size, const QString &name)
+{
+    const QByteArray bytes = name.toLatin1();
+    std::memset(dst, 0, size);
+    std::memcpy(dst, bytes.constData(), qMin(size_t(bytes.size()), size - 1));
+}
+
+} // namespace
+
+StateServer::StateServer(const AwardEngine *awards, QObject *parent)
+    : QObject(parent), m_awards(awards)
+{
+    connect(&m_pollTimer, &QTimer::timeout, this, &StateServer::publish);
+}
+
+StateServer::~StateServer()
+{
+    if (m_map) {
+        reinterpret_cast<SharedState::Header *>(m_map)->retired = 1;
+        m_file.unmap(m_map);
+    }
+}
+
+bool StateServer::start(const QString &stateFile, const QString &socketName)
+{
+    bool ok = true;
+
+    if (!stateFile.isEmpty()) {
+        m_path = stateFile;
+        if (createFile(kMinCapacity)) {
+            publish();
+            m_pollTimer.start(kPollMs);
+        } else {
+            ok = false;
+        }
+    }
+
+    if (!socketName.isEmpty()) {
+        m_server = new QLocalServer(this);
+        QLocalServer::removeServer(socketName);     // stale socket from a crashed run
+        if (m_server->listen(socketName)) {
+            connect(m_server, &QLocalServer::newConnection, this, &StateServer::onNewConnection);
+            qDebug() << "State queries on" << m_server->fullServerName();
+        } else {
+            qWarning() << "Cannot listen on" << socketName << "-" << m_server->errorString();
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// Readers keep their mapping of the old file, so it is marked retired and
+// unlinked rather than truncated under them.
+bool StateServer::createFile(quint64 capacity)
+{
+    if (m_map) {
+        reinterpret_cast<SharedState::Header *>(m_map)->retired = 1;
+        m_file.unmap(m_map);
+        m_map = nullptr;
+        m_file.close();
+    } else {
+        QFile old(m_path);
+        if (old.size() >= qint64(sizeof(SharedState::Header)) && old.open(QIODevice::ReadWrite)) {
+            auto *h = reinterpret_cast<SharedState::Header *>(old.map(0, sizeof(SharedState::Header)));
+            if (h && std::memcmp(h->magic, SharedState::kMagic, sizeof(SharedState::kMagic)) == 0) {
+                h->retired = 1;
+            }
+        }
+    }
+    QFile::remove(m_path);
+
+    m_file.setFileName(m_path);
+    if (!m_file.open(QIODevice::ReadWrite) || !m_file.resize(qint64(capacity))) {
+        qWarning() << "Cannot create shared state" << m_path << "-" << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+    m_map = m_file.map(0, qint64(capacity));
+    if (!m_map) {
+        qWarning() << "Cannot map shared state" << m_path << "-" << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    // The file is zero-filled, so the sequence already reads as 0.
+    auto *h = reinterpret_cast<SharedState::Header *>(m_map);
+    std::memcpy(h->magic, SharedState::kMagic, sizeof(SharedState::kMagic));
+    h->version = SharedState::kVersion;
+    h->headerSize = sizeof(SharedState::Header);
+    h->capacity = capacity;
+    m_capacity = capacity;
+    m_published = ~quint64(0);
+    return true;
+}
+
+QByteArray StateServer::buildPayload() const
+{
+    QByteArray payload;
+    for (int i = 0; i < m_awards->awardCount(); ++i) {
+        const AwardDefinition &def = m_awards->award(i);
+        const int bandCount = qMin(int(def.bands.size()), SharedState::kMaxBands);
+        const int modeCount = qMin(int(def.modes.size()), SharedState::kMaxModes);
+
+        // Sorted by call for readers' binary search; rows for the same call
+        // (added twice by hand) are merged.
+        QMap<QByteArray, SharedState::Entry> entries;
+        for (int row = 0; row < m_awards->rowCount(i); ++row) {
+            const QByteArray call = m_awards->rowCall(i, row).toLatin1();
+            if (call.isEmpty() || call.size() >= SharedState::kCallBytes) {
+                continue;
+            }
+            auto it = entries.find(call);
+            if (it == entries.end()) {
+                SharedState::Entry entry{};
+                std::memcpy(entry.call, call.constData(), size_t(call.size()));
+                it = entries.insert(call, entry);
+            }
+            for (int b = 0; b < bandCount; ++b) {
+                it->masks[b] |= quint8(m_awards->mask(i, row, b));
+            }
+        }
+
+        SharedState::Award award{};
+        copyName(award.name, sizeof(award.name), def.name);
+        award.rows = quint32(entries.size());
+        award.bandCount = quint32(bandCount);
+        award.modeCount = quint32(modeCount);
+        for (int b = 0; b < bandCount; ++b) {
+            copyName(award.bands[b], sizeof(award.bands[b]), def.bands[b]);
+        }
+        for (int m = 0; m < modeCount; ++m) {
+            copyName(award.modes[m], sizeof(award.modes[m]), def.modes[m].name);
+            award.points[m] = quint8(qBound(0, def.modes[m].points, 255));
+        }
+
+        payload.append(reinterpret_cast<const char *>(&award), sizeof(award));
+        for (const SharedState::Entry &entry : entries) {
+            payload.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+        }
+    }
+    return payload;
+}
+
+void StateServer::publish()
+{
+    if (!m_map || m_awards->generation() == m_published) {
+        return;
+    }
+
+    const QByteArray payload = buildPayload();
+    const quint64 needed = sizeof(SharedState::Header) + quint64(payload.size());
+    if (needed > m_capacity && !createFile(qMax(needed * 2, kMinCapacity))) {
+        return;
+    }
+
+    auto *h = reinterpret_cast<SharedState::Header *>(m_map);
+    const quint32 seq = h->sequence.load(std::memory_order_relaxed);
+    h->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(m_map + sizeof(SharedState::Header), payload.constData(), size_t(payload.size()));
+    h->awardCount = quint32(m_awards->awardCount());
+    h->payloadSize = quint64(payload.size());
+    h->generation = m_awards->generation();
+
+    h->sequence.store(seq + 2, std::memory_order_release);
+    m_published = m_awards->generation();
+}
+
+void StateServer::onNewConnection()
+{
+    while (QLocalSocket *client = m_server->nextPendingConnection()) {
+        connect(client, &QLocalSocket::disconnected, client, &QObject::deleteLater);
+        connect(client, &QLocalSocket::readyRead, this, [this, client]() {
+            while (client->canReadLine()) {
+                client->write(answer(client->readLine().trimmed()) + '\n');
+            }
+            if (client->bytesAvailable() > kMaxRequestBytes) {
+                client->abort();    // no newline in sight; not a client of ours
+            }
+        });
+    }
+}
+
+QByteArray StateServer::answer(const QByteArray &request) const
+{
+    const QList<QByteArray> args = request.simplified().split(' ');
+    const QByteArray command = args.value(0).toUpper();
+
+    if (command == "GENERATION" && args.size() == 1) {
+        return QByteArray::number(m_awards->generation());
+    }
+
+    if (command == "NEEDED" && args.size() == 4) {
+        const QString call = QString::fromLatin1(args[1]).toUpper();
+        const QString band = QString::fromLatin1(args[2]).toLower().remove('m');
+        const QString mode = QString::fromLatin1(args[3]);
+        const QVector<AwardEngine::Slot> *slots = m_awards->lookup(call);
+        if (!slots || !m_awards->isNeeded(*slots, band, mode)) {
+            return "NO";
+        }
+        return "YES " + QByteArray::number(m_awards->pointGain(*slots, band, mode));
+    }
+
+    if (command == "LOOKUP" && args.size() == 2) {
+        const QVector<AwardEngine::Slot> *slots = m_awards->lookup(QString::fromLatin1(args[1]).toUpper());
+        if (!slots) {
+            return "NONE";
+        }
+        QByteArrayList awards;
+        for (const AwardEngine::Slot &slot : *slots) {
+            const AwardDefinition &def = m_awards->award(slot.award);
+            QByteArray line = def.name.toUtf8().replace(' ', '_');
+            for (int b = 0; b < def.bands.size(); ++b) {
+                const int mask = m_awards->mask(slot.award, slot.row, b);
+                QByteArrayList modes;
+                for (int bit = 0; bit < def.modes.size(); ++bit) {
+                    if (mask & (1 << bit)) {
+                        modes << def.modes[bit].name.toUtf8();
+                    }
+                }
+                line += ' ' + def.bands[b].toUtf8() + ':' + (modes.isEmpty() ? QByteArray("-") : modes.join(','));
+            }
+            awards << line;
+        }
+        return awards.join(" ; ");
+    }
+
+    return "ERR expected NEEDED <call> <band> <mode>, LOOKUP <call> or GENERATION";
+}
@@ -0,0 +1,55 @@
+#ifndef STATESERVER_H
+#define STATESERVER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+class AwardEngine;
+class QLocalServer;
+class QLocalSocket;
+
+// Read-only access to award state for other local tools.
+//
+// The state is published to a memory-mapped file laid out as described in
+// sharedstate.h, rewritten under a seqlock whenever the engine's generation
+// changes. A QLocalServer (a Unix domain socket on Linux and macOS) answers
+// one-line queries for tools that would rather not map the file:
+//
+//   NEEDED <call> <band> <mode>  ->  YES <points> | NO
+//   LOOKUP <call>                ->  <award> <band>:<modes> ... ; ... | NONE
+//   GENERATION                   ->  <generation>
+//
+// Anything else gets "ERR <reason>". Every answer is one line.
+class StateServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit StateServer(const AwardEngine *awards, QObject *parent = nullptr);
+    ~StateServer();
+
+    // Either may be empty to leave that interface off.
+    bool start(const QString &stateFile, const QString &socketName);
+
+    // Rewrites the shared file if the award state changed since last time.
+    void publish();
+
+private:
+    bool createFile(quint64 capacity);
+    QByteArray buildPayload() const;
+    QByteArray answer(const QByteArray &request) const;
+    void onNewConnection();
+
+    const AwardEngine *m_awards;
+    QString m_path;
+    QFile m_file;
+    uchar *m_map = nullptr;
+    quint64 m_capacity = 0;
+    quint64 m_published = ~quint64(0);
+    QTimer m_pollTimer;
+    QLocalServer *m_server = nullptr;
+};
+
+#endif // STATESERVER_H
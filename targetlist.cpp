@@ -0,0 +1,127 @@
+#include "targetlist.h"
+
+#include <QFile>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QDebug>
+
+namespace TargetList {
+
+bool load(const QString &path, QStringList *calls, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    QSet<QString> seen;
+    calls->clear();
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        const QString call = QString::fromLatin1(line).toUpper();
+        if (seen.contains(call)) {
+            continue;
+        }
+        seen.insert(call);
+        calls->append(call);
+    }
+    return true;
+}
+
+int seed(const QString &table, const QStringList &bands, const QStringList &calls, QSqlDatabase db)
+{
+    QSet<QString> existing;
+    {
+        QSqlQuery q(db);
+        q.setForwardOnly(true);
+        if (!q.exec(QString("SELECT callsign FROM %1").arg(table))) {
+            qWarning() << "Failed to read callsigns:" << q.lastError();
+            return -1;
+        }
+        while (q.next()) {
+            existing.insert(q.value(0).toString().trimmed().toUpper());
+        }
+    }
+
+    QStringList missing;
+    for (const QString &call : calls) {
+        if (!existing.contains(call)) {
+            missing.append(call);
+        }
+    }
+    if (missing.isEmpty()) {
+        return 0;
+    }
+
+    return apply(table, bands, missing, QStringList(), nullptr, db) ? missing.size() : -1;
+}
+
+bool apply(const QString &table, const QStringList &bands, const QStringList &add,
+           const QStringList &remove, QVector<qint64> *ids, QSqlDatabase db)
+{
+    QString columns = "callsign";
+    QString values = "?";
+    for (const QString &band : bands) {
+        columns += QString(R"(, "%1")").arg(band);
+        values += ", 0";
+    }
+
+    if (!db.transaction()) {
+        qWarning() << "Failed to begin transaction:" << db.lastError();
+        return false;
+    }
+
+    if (!add.isEmpty()) {
+        QSqlQuery insert(db);
+        if (!insert.prepare(QString("INSERT INTO %1 (%2) VALUES (%3)").arg(table, columns, values))) {
+            qWarning() << "Failed to prepare insert:" << insert.lastError();
+            db.rollback();
+            return false;
+        }
+        for (const QString &call : add) {
+            insert.bindValue(0, call);
+            if (!insert.exec()) {
+                qWarning() << "Insert failed for call:" << call << insert.lastError();
+                db.rollback();
+                return false;
+            }
+            if (ids) {
+                ids->append(insert.lastInsertId().toLongLong());
+            }
+        }
+    }
+
+    if (!remove.isEmpty()) {
+        QSqlQuery del(db);
+        if (!del.prepare(QString("DELETE FROM %1 WHERE UPPER(TRIM(callsign)) = ?").arg(table))) {
+            qWarning() << "Failed to prepare delete:" << del.lastError();
+            db.rollback();
+            return false;
+        }
+        for (const QString &call : remove) {
+            del.bindValue(0, call);
+            if (!del.exec()) {
+                qWarning() << "Delete failed for call:" << call << del.lastError();
+                db.rollback();
+                return false;
+            }
+        }
+    }
+
+    if (!db.commit()) {
+        qWarning() << "Failed to commit target changes:" << db.lastError();
+        db.rollback();
+        return false;
+    }
+    return true;
+}
+
+} // namespace TargetList
@@ -0,0 +1,30 @@
+#ifndef TARGETLIST_H
+#define TARGETLIST_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Target station lists are plain text files: one callsign per line,
+// blank lines and lines starting with '#' are ignored. Callsigns are
+// returned upper-cased, de-duplicated, in file order.
+namespace TargetList {
+
+bool load(const QString &path, QStringList *calls, QString *error = nullptr);
+
+// Inserts every callsign from `calls` that is not yet present in `table`.
+// All inserts share one prepared statement inside a single transaction.
+// Returns the number of rows added, or -1 on failure.
+int seed(const QString &table, const QStringList &bands, const QStringList &calls,
+         QSqlDatabase db = QSqlDatabase::database());
+
+// Inserts `add` and deletes every row whose callsign is in `remove`, in one
+// transaction. Row ids of the inserted calls are appended to `ids` in order.
+bool apply(const QString &table, const QStringList &bands, const QStringList &add,
+           const QStringList &remove, QVector<qint64> *ids = nullptr,
+           QSqlDatabase db = QSqlDatabase::database());
+
+} // namespace TargetList
+
+#endif // TARGETLIST_H
@@ -0,0 +1,410 @@
+// wwa-loadgen: local stand-ins for the RBN telnet feed and WSJT-X UDP
+// traffic, for offline soak tests of WWA.
+//
+//   wwa-loadgen --rbn-port 7300 --rate 200 --shape burst
+//   wwa-loadgen --udp 127.0.0.1:2333 --instances 3 --decode-rate 20
+//
+// Point WWA at it with --rbn 127.0.0.1:7300 --udp 127.0.0.1:2333.
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHostAddress>
+#include <QRandomGenerator>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QDebug>
+
+namespace {
+
+struct BandPlan {
+    const char *band;
+    double cwKhz;       // start of the CW segment
+    double ft8Khz;      // FT8 dial frequency
+};
+
+const BandPlan kBands[] = {
+    {"80", 3500.0, 3573.0}, {"40", 7000.0, 7074.0}, {"30", 10100.0, 10136.0},
+    {"20", 14000.0, 14074.0}, {"17", 18068.0, 18100.0}, {"15", 21000.0, 21074.0},
+    {"12", 24890.0, 24915.0}, {"10", 28000.0, 28074.0},
+};
+
+const char *kSkimmers[] = {
+    "OH6BG-#", "DK8NE-#", "W3LPL-#", "VE6WZ-#", "JA1AZR-#", "KM3T-#", "G4ZFE-#", "EA5WU-#",
+};
+
+QRandomGenerator *rng() { return QRandomGenerator::global(); }
+
+template <typename T, int N>
+const T &pick(const T (&items)[N]) { return items[rng()->bounded(N)]; }
+
+QString randomCall()
+{
+    static const char *prefixes[] = {"DL", "F", "G", "I", "EA", "K", "W", "N", "JA", "VK", "OH", "SM", "LY", "UA"};
+    QString call = pick(prefixes);
+    call += QString::number(rng()->bounded(10));
+    for (int i = 0, n = 2 + rng()->bounded(2); i < n; ++i) {
+        call += QChar('A' + rng()->bounded(26));
+    }
+    return call;
+}
+
+// Draws callsigns, `targetRatio` of them from the target list.
+class CallSource
+{
+public:
+    CallSource(const QStringList &targets, double targetRatio)
+        : m_targets(targets), m_ratio(targetRatio) {}
+
+    QString next() const
+    {
+        if (!m_targets.isEmpty() && rng()->generateDouble() < m_ratio) {
+            return m_targets[rng()->bounded(m_targets.size())];
+        }
+        return randomCall();
+    }
+
+private:
+    QStringList m_targets;
+    double m_ratio;
+};
+
+// ---------------------------------------------------------------------------
+// RBN telnet server
+
+class RbnServer : public QObject
+{
+public:
+    RbnServer(const CallSource &calls, double rate, const QString &shape, int burstSize,
+              int burstIntervalMs, QObject *parent = nullptr)
+        : QObject(parent), m_calls(calls), m_rate(rate), m_shape(shape),
+          m_burstSize(burstSize), m_burstIntervalMs(burstIntervalMs)
+    {
+        connect(&m_server, &QTcpServer::newConnection, this, [this]() {
+            while (QTcpSocket *client = m_server.nextPendingConnection()) {
+                accept(client);
+            }
+        });
+        connect(&m_tick, &QTimer::timeout, this, &RbnServer::tick);
+    }
+
+    bool listen(quint16 port)
+    {
+        if (!m_server.listen(QHostAddress::LocalHost, port)) {
+            qWarning() << "RBN server: cannot listen on" << port << "-" << m_server.errorString();
+            return false;
+        }
+        qInfo() << "RBN server listening on 127.0.0.1:" << port << "rate" << m_rate << "/s shape" << m_shape;
+        m_clock.start();
+        m_tick.start(m_shape == "burst" ? m_burstIntervalMs : 10);
+        return true;
+    }
+
+private:
+    void accept(QTcpSocket *client)
+    {
+        qInfo() << "RBN client connected from" << client->peerAddress().toString();
+        client->write("Please enter your call: ");
+        connect(client, &QTcpSocket::readyRead, this, [this, client]() {
+            const QByteArray line = client->readAll().trimmed();
+            if (!m_clients.contains(client) && !line.isEmpty()) {
+                client->write("\r\nHello " + line + ", this is the WWA load generator.\r\n\r\n");
+                m_clients.append(client);
+                qInfo() << "RBN client logged in as" << line;
+            }
+        });
+        connect(client, &QTcpSocket::disconnected, this, [this, client]() {
+            m_clients.removeAll(client);
+            client->deleteLater();
+            qInfo() << "RBN client disconnected";
+        });
+    }
+
+    QByteArray spotLine() const
+    {
+        const BandPlan &band = pick(kBands);
+        const int kind = rng()->bounded(10);
+        const char *mode = kind < 7 ? "CW" : (kind < 9 ? "FT8" : "RTTY");
+        const double khz = qstrcmp(mode, "FT8") == 0
+            ? band.ft8Khz + rng()->bounded(3000) / 1000.0
+            : band.cwKhz + rng()->bounded(600) / 10.0;
+        const QString time = QDateTime::currentDateTimeUtc().toString("HHmm") + "Z";
+
+        // DX de OH6BG-#:    14025.0  DL0WWA       CW    23 dB  22 WPM  CQ      1234Z
+        return QString("DX de %1 %2  %3 %4 %5 dB  %6 WPM  CQ      %7\r\n")
+            .arg(QString(pick(kSkimmers)) + ":", -12)
+            .arg(khz, 8, 'f', 1)
+            .arg(m_calls.next(), -12)
+            .arg(QString(mode), -4)
+            .arg(rng()->bounded(3, 40), 3)
+            .arg(rng()->bounded(14, 35), 2)
+            .arg(time)
+            .toLatin1();
+    }
+
+    void tick()
+    {
+        // Spots owed so far minus spots sent keeps the average rate exact.
+        double rate = m_rate;
+        if (m_shape == "ramp") {
+            rate = m_rate * qMin(1.0, m_clock.elapsed() / 60000.0);     // 0 -> rate over a minute
+        }
+
+        int count = 0;
+        if (m_shape == "burst") {
+            count = m_burstSize;
+        } else {
+            m_owed += rate * (m_clock.elapsed() - m_lastTickMs) / 1000.0;
+            count = int(m_owed);
+            m_owed -= count;
+        }
+        m_lastTickMs = m_clock.elapsed();
+
+        if (count == 0 || m_clients.isEmpty()) {
+            return;
+        }
+
+        QByteArray chunk;
+        for (int i = 0; i < count; ++i) {
+            chunk += spotLine();
+        }
+        for (QTcpSocket *client : m_clients) {
+            client->write(chunk);
+        }
+        m_sent += count;
+        if (m_sent / 10000 != (m_sent - count) / 10000) {
+            qInfo() << "RBN spots sent:" << m_sent;
+        }
+    }
+
+    QTcpServer m_server;
+    QTimer m_tick;
+    QElapsedTimer m_clock;
+    QList<QTcpSocket *> m_clients;
+    CallSource m_calls;
+    double m_rate;
+    QString m_shape;
+    int m_burstSize;
+    int m_burstIntervalMs;
+    double m_owed = 0.0;
+    qint64 m_lastTickMs = 0;
+    qint64 m_sent = 0;
+};
+
+// ---------------------------------------------------------------------------
+// WSJT-X UDP emitter (schema 3)
+
+class WsjtxEmitter : public QObject
+{
+public:
+    WsjtxEmitter(const CallSource &calls, const QHostAddress &address, quint16 port, int instances,
+                 double decodeRate, double qsoRate, QObject *parent = nullptr)
+        : QObject(parent), m_calls(calls), m_address(address), m_port(port),
+          m_decodeRate(decodeRate), m_qsoRate(qsoRate)
+    {
+        for (int i = 0; i < instances; ++i) {
+            const BandPlan &band = kBands[i % int(sizeof(kBands) / sizeof(kBands[0]))];
+            m_instances.append(Instance{QString("LOADGEN-%1").arg(i + 1), quint64(band.ft8Khz * 1000.0),
+                                i % 2 ? "FT4" : "FT8"});
+        }
+
+        connect(&m_heartbeat, &QTimer::timeout, this, [this]() {
+            for (const Instance &inst : m_instances) {
+                sendHeartbeat(inst);
+                sendStatus(inst);
+            }
+        });
+        connect(&m_tick, &QTimer::timeout, this, &WsjtxEmitter::tick);
+    }
+
+    void start()
+    {
+        qInfo() << "WSJT-X emitter ->" << m_address.toString() << ":" << m_port
+                << m_instances.size() << "instances," << m_decodeRate << "decodes/s";
+        for (const Instance &inst : m_instances) {
+            sendHeartbeat(inst);
+            sendStatus(inst);
+        }
+        m_clock.start();
+        m_heartbeat.start(15000);
+        m_tick.start(10);
+    }
+
+private:
+    struct Instance {
+        QString id;
+        quint64 dialHz;
+        QString mode;
+    };
+
+    QByteArray header(quint32 type, const QString &id) const
+    {
+        QByteArray out;
+        QDataStream ds(&out, QIODevice::WriteOnly);
+        ds.setVersion(QDataStream::Qt_5_4);
+        ds.setByteOrder(QDataStream::BigEndian);
+        ds << quint32(0xadbccbda) << quint32(3) << type << id.toUtf8();
+        return out;
+    }
+
+    void send(const QByteArray &datagram)
+    {
+        m_socket.writeDatagram(datagram, m_address, m_port);
+    }
+
+    void sendHeartbeat(const Instance &inst)
+    {
+        QByteArray out = header(0, inst.id);
+        QDataStream ds(&out, QIODevice::Append);
+        ds.setVersion(QDataStream::Qt_5_4);
+        ds << quint32(3) << QByteArray("loadgen") << QByteArray("0");
+        send(out);
+    }
+
+    void sendStatus(const Instance &inst)
+    {
+        QByteArray out = header(1, inst.id);
+        QDataStream ds(&out, QIODevice::Append);
+        ds.setVersion(QDataStream::Qt_5_4);
+        ds << inst.dialHz << inst.mode.toUtf8() << QByteArray() << QByteArray() << inst.mode.toUtf8()
+           << false << false << true << quint32(1500) << quint32(1500)
+           << QByteArray("OG3Z") << QByteArray("KP20") << QByteArray()
+           << false << QByteArray() << false << quint8(0) << quint32(0)
+           << quint32(inst.mode == "FT4" ? 7 : 15) << QByteArray("Default") << QByteArray();
+        send(out);
+    }
+
+    void sendDecode(const Instance &inst)
+    {
+        const QString call = m_calls.next();
+        const QString message = rng()->bounded(3) == 0
+            ? QString("CQ %1 JO%2").arg(call).arg(rng()->bounded(10, 99))
+            : QString("OG3Z %1 -%2").arg(call).arg(rng()->bounded(1, 24), 2, 10, QLatin1Char('0'));
+
+        // The decode time carries the send time (UTC, ms) so WWA can measure
+        // end-to-end latency with --measure-latency.
+        QByteArray out = header(2, inst.id);
+        QDataStream ds(&out, QIODevice::Append);
+        ds.setVersion(QDataStream::Qt_5_4);
+        ds << true << QDateTime::currentDateTimeUtc().time() << qint32(-rng()->bounded(24))
+           << 0.1 << quint32(rng()->bounded(200, 2800))
+           << QByteArray(inst.mode == "FT4" ? "+" : "~") << message.toUtf8() << false << false;
+        send(out);
+    }
+
+    void sendQsoLogged(const Instance &inst)
+    {
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        QByteArray out = header(5, inst.id);
+        QDataStream ds(&out, QIODevice::Append);
+        ds.setVersion(QDataStream::Qt_5_4);
+        ds << now << m_calls.next().toUtf8() << QByteArray("JO22") << inst.dialHz << inst.mode.toUtf8()
+           << QByteArray("-10") << QByteArray("-12") << QByteArray("100") << QByteArray() << QByteArray()
+           << now.addSecs(-60) << QByteArray() << QByteArray("OG3Z") << QByteArray("KP20")
+           << QByteArray() << QByteArray() << QByteArray();
+        send(out);
+    }
+
+    void tick()
+    {
+        const qint64 elapsed = m_clock.elapsed();
+        const double seconds = (elapsed - m_lastTickMs) / 1000.0;
+        m_lastTickMs = elapsed;
+
+        m_owedDecodes += m_decodeRate * seconds;
+        m_owedQsos += m_qsoRate * seconds;
+        for (; m_owedDecodes >= 1.0; m_owedDecodes -= 1.0) {
+            sendDecode(m_instances[rng()->bounded(m_instances.size())]);
+        }
+        for (; m_owedQsos >= 1.0; m_owedQsos -= 1.0) {
+            sendQsoLogged(m_instances[rng()->bounded(m_instances.size())]);
+        }
+    }
+
+    QUdpSocket m_socket;
+    QTimer m_heartbeat;
+    QTimer m_tick;
+    QElapsedTimer m_clock;
+    CallSource m_calls;
+    QHostAddress m_address;
+    quint16 m_port;
+    double m_decodeRate;
+    double m_qsoRate;
+    QList<Instance> m_instances;
+    double m_owedDecodes = 0.0;
+    double m_owedQsos = 0.0;
+    qint64 m_lastTickMs = 0;
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Mock RBN telnet server and WSJT-X UDP traffic generator for WWA");
+    parser.addHelpOption();
+    parser.addOption({"rbn-port", "Serve a mock RBN feed on 127.0.0.1:<port>.", "port"});
+    parser.addOption({"rate", "RBN spots per second (default 50).", "n", "50"});
+    parser.addOption({"shape", "RBN traffic shape: steady, burst or ramp (default steady).", "shape", "steady"});
+    parser.addOption({"burst-size", "Spots per burst for --shape burst (default 500).", "n", "500"});
+    parser.addOption({"burst-interval", "Milliseconds between bursts (default 5000).", "ms", "5000"});
+    parser.addOption({"udp", "Send WSJT-X traffic to host:port.", "endpoint"});
+    parser.addOption({"instances", "Number of WSJT-X instances (default 2).", "n", "2"});
+    parser.addOption({"decode-rate", "Decodes per second over all instances (default 10).", "n", "10"});
+    parser.addOption({"qso-rate", "QSO Logged messages per second (default 0.05).", "n", "0.05"});
+    parser.addOption({"targets", "Target list to draw callsigns from.", "file"});
+    parser.addOption({"target-ratio", "Share of spots and decodes for target stations (default 0.2).", "ratio", "0.2"});
+    parser.process(app);
+
+    QStringList targets;
+    if (parser.isSet("targets")) {
+        QFile file(parser.value("targets"));
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            qCritical() << "Cannot read" << file.fileName() << "-" << file.errorString();
+            return 1;
+        }
+        while (!file.atEnd()) {
+            const QByteArray line = file.readLine().trimmed();
+            if (!line.isEmpty() && !line.startsWith('#')) {
+                targets << QString::fromLatin1(line).toUpper();
+            }
+        }
+    }
+    const CallSource calls(targets, parser.value("target-ratio").toDouble());
+
+    if (!parser.isSet("rbn-port") && !parser.isSet("udp")) {
+        parser.showHelp(1);
+    }
+
+    if (parser.isSet("rbn-port")) {
+        auto *rbn = new RbnServer(calls, parser.value("rate").toDouble(), parser.value("shape"),
+                                  parser.value("burst-size").toInt(), parser.value("burst-interval").toInt(), &app);
+        if (!rbn->listen(quint16(parser.value("rbn-port").toUInt()))) {
+            return 1;
+        }
+    }
+
+    if (parser.isSet("udp")) {
+        const QString endpoint = parser.value("udp");
+        const int colon = endpoint.lastIndexOf(':');
+        const QHostAddress address(colon > 0 ? endpoint.left(colon) : QString("127.0.0.1"));
+        const quint16 port = quint16(endpoint.mid(colon + 1).toUInt());
+        if (address.isNull() || port == 0) {
+            qCritical() << "Invalid UDP endpoint:" << endpoint;
+            return 1;
+        }
+        auto *wsjtx = new WsjtxEmitter(calls, address, port, qMax(1, parser.value("instances").toInt()),
+                                       parser.value("decode-rate").toDouble(),
+                                       parser.value("qso-rate").toDouble(), &app);
+        wsjtx->start();
+    }
+
+    return app.exec();
+}
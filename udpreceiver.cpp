@@ -1,7 +1,13 @@
 #include "udpreceiver.h"
 #include <QDataStream>
 #include <QTime>
+#include <QNetworkInterface>
+#include <QVector>
 #include <QDebug>
+#include <cstring>
+
+// WSJT-X sends a heartbeat every 15 s; drop instances silent for longer than this.
+static constexpr qint64 kInstanceTimeoutMs = 60 * 1000;
 
 static QString readUtf8(QDataStream &ds)
 {
@@ -19,7 +25,7 @@ static void setStreamVersionFromSchema(QDataStream &ds, quint32 schema)
     else             ds.setVersion(QDataStream::Qt_5_2);
 }
 
-static bool decodeType2(QDataStream &ds, const QString &id)
+static bool decodeType2_DecodeAndEmit(QDataStream &ds, const QString &id, UdpReceiver *self)
 {
     bool isNew = false;
     QTime time;
@@ -50,19 +56,25 @@ static bool decodeType2(QDataStream &ds, const QString &id)
         return false;
     }
 
-    qDebug().noquote()
-        << "DECODE(type=2)"
-        << "id=" << id
-        << "new=" << isNew
-        << "time=" << time.toString("HH:mm:ss")
-        << "snr=" << snr
-        << "dt=" << deltaTime
-        << "df=" << deltaFreq
-        << "mode=" << mode
-        << "msg=" << message
-        << "lowconf=" << lowConfidence
-        << "offair=" << offAir;
+    // qDebug().noquote()
+    //     << "DECODE(type=2)"
+    //     << "id=" << id
+    //     << "new=" << isNew
+    //     << "time=" << time.toString("HH:mm:ss")
+    //     << "snr=" << snr
+    //     << "dt=" << deltaTime
+    //     << "df=" << deltaFreq
+    //     << "mode=" << mode
+    //     << "msg=" << message
+    //     << "lowconf=" << lowConfidence
+    //     << "offair=" << offAir;
+
+    // Replays of old decodes (e.g. after a band change) are not new activity.
+    if (!isNew || offAir) {
+        return true;
+    }
 
+    emit self->decoded(id, time, snr, deltaTime, deltaFreq, mode, message, lowConfidence);
     return true;
 }
 
@@ -138,10 +150,67 @@ static bool decodeType6(QDataStream &ds, const QString &id)
     return true;
 }
 
-static QString bandFromHz(quint64 hz)
+static bool decodeType0_Heartbeat(QDataStream &ds, WsjtxInstance &inst)
+{
+    quint32 maxSchema = 0;
+    ds >> maxSchema;
+    const QString version  = readUtf8(ds);
+    const QString revision = readUtf8(ds);
+
+    if (ds.status() != QDataStream::Ok) {
+        qWarning() << "Type0 decode failed:" << ds.status();
+        return false;
+    }
+
+    inst.maxSchema = maxSchema;
+    inst.version = revision.isEmpty() ? version : version + " " + revision;
+    inst.lastHeartbeat = QDateTime::currentDateTimeUtc();
+    return true;
+}
+
+static bool decodeType1_Status(QDataStream &ds, WsjtxInstance &inst)
+{
+    // Dial Frequency, Mode, DX call, Report, Tx Mode, Tx Enabled, Transmitting,
+    // Decoding, Rx DF, Tx DF, DE call, DE grid, ... (only the leading fields are read)
+    quint64 dialFreqHz = 0;
+    bool txEnabled = false;
+    bool transmitting = false;
+    bool decoding = false;
+    quint32 rxDf = 0;
+    quint32 txDf = 0;
+
+    ds >> dialFreqHz;
+    const QString mode   = readUtf8(ds);
+    const QString dxCall = readUtf8(ds);
+    const QString report = readUtf8(ds);
+    const QString txMode = readUtf8(ds);
+    ds >> txEnabled >> transmitting >> decoding >> rxDf >> txDf;
+    const QString deCall = readUtf8(ds);
+    const QString deGrid = readUtf8(ds);
+
+    if (ds.status() != QDataStream::Ok) {
+        qWarning() << "Type1 decode failed:" << ds.status();
+        return false;
+    }
+
+    inst.dialFreqHz = dialFreqHz;
+    inst.mode = mode.trimmed().toUpper();
+    inst.dxCall = dxCall.trimmed().toUpper();
+    inst.txEnabled = txEnabled;
+    inst.transmitting = transmitting;
+    inst.decoding = decoding;
+    inst.deCall = deCall;
+    inst.deGrid = deGrid;
+    inst.lastStatus = QDateTime::currentDateTimeUtc();
+    return true;
+}
+
+QString UdpReceiver::bandFromHz(quint64 hz)
 {
-    // Return strings matching your DB columns: "10","12","15","17","20","30","40","80"
+    // Return strings matching award band columns: "2","6","10","12",... "160"
     // (rough band edges; adjust if you want strict digital subbands)
+    if (hz >= 144000000ULL && hz <= 148000000ULL) return "2";
+    if (hz >= 50000000ULL && hz <= 54000000ULL) return "6";
     if (hz >= 28000000ULL && hz <= 29700000ULL) return "10";
     if (hz >= 24890000ULL && hz <= 24990000ULL) return "12";
     if (hz >= 21000000ULL && hz <= 21450000ULL) return "15";
@@ -149,11 +218,13 @@ static QString bandFromHz(quint64 hz)
     if (hz >= 14000000ULL && hz <= 14350000ULL) return "20";
     if (hz >= 10100000ULL && hz <= 10150000ULL) return "30";
     if (hz >=  7000000ULL && hz <=  7300000ULL) return "40";
+    if (hz >=  5351500ULL && hz <=  5366500ULL) return "60";
     if (hz >=  3500000ULL && hz <=  4000000ULL) return "80";
+    if (hz >=  1800000ULL && hz <=  2000000ULL) return "160";
     return ""; // unknown/not one of your columns
 }
 
-static bool decodeType5_QsoLoggedAndEmit(QDataStream &ds, UdpReceiver *self)
+static bool decodeType5_QsoLoggedAndEmit(QDataStream &ds, const QString &id, UdpReceiver *self)
 {
     // Type 5 (QSO Logged): common fields
     // DateTimeOff, dxCall, dxGrid, dialFreqHz, mode, rptSent, rptRcvd, txPower, comments, name
@@ -185,7 +256,7 @@ static bool decodeType5_QsoLoggedAndEmit(QDataStream &ds, UdpReceiver *self)
         return true; // decoded fine, but ignore other modes
     }
 
-    const QString band = bandFromHz(dialFreqHz);
+    const QString band = UdpReceiver::bandFromHz(dialFreqHz);
     if (band.isEmpty()) {
         // Not one of your DB columns; still can emit if you want.
         qDebug().noquote() << "QSO_LOGGED (ignored band) call=" << dxCall
@@ -205,11 +276,217 @@ static bool decodeType5_QsoLoggedAndEmit(QDataStream &ds, UdpReceiver *self)
     //                    << "name=" << name
     //                    << "comments=" << comments;
 
-    emit self->qsoLogged(dxCall, band, modeUp);
+    emit self->qsoLogged(id, dxCall, band, modeUp);
     return true;
 }
 
-static void decodeWsjtxDatagram(const QByteArray &datagram, UdpReceiver *self)
+// ---------------------------------------------------------------------------
+// Logger feeds: N1MM+ <contactinfo> XML and plain ADIF records.
+//
+// Both are pull-parsed in place: fields are byte ranges into the datagram
+// and only call, band, mode, submode and frequency are ever copied out.
+
+namespace {
+
+struct Span {
+    const char *p = nullptr;
+    int n = 0;
+
+    bool isEmpty() const { return n == 0; }
+    bool equals(const char *s) const { return int(qstrlen(s)) == n && qstrnicmp(p, s, uint(n)) == 0; }
+    QString toString() const { return QString::fromUtf8(p, n).trimmed(); }
+};
+
+struct LoggedContact {
+    Span call;
+    Span band;          // N1MM: MHz ("14"), ADIF: "20m"
+    Span mode;
+    Span submode;
+    quint64 freqHz = 0;
+};
+
+quint64 parseHz(const Span &s, double scale)
+{
+    bool ok = false;
+    const double v = QByteArray::fromRawData(s.p, s.n).trimmed().toDouble(&ok);
+    return ok && v > 0 ? quint64(v * scale + 0.5) : 0;
+}
+
+// Band column for a contact: the frequency when there is one, else the band
+// field, which is meters in ADIF and MHz in N1MM.
+QString contactBand(const LoggedContact &c, bool bandInMhz)
+{
+    if (c.freqHz) {
+        return UdpReceiver::bandFromHz(c.freqHz);
+    }
+    if (c.band.isEmpty()) {
+        return QString();
+    }
+    if (bandInMhz) {
+        static const char *const mhzToMeters[][2] = {
+            {"1.8", "160"}, {"3.5", "80"}, {"5", "60"}, {"7", "40"}, {"10", "30"}, {"14", "20"},
+            {"18", "17"}, {"21", "15"}, {"24", "12"}, {"28", "10"}, {"50", "6"}, {"144", "2"},
+        };
+        for (const auto &entry : mhzToMeters) {
+            if (c.band.equals(entry[0])) {
+                return QString(entry[1]);
+            }
+        }
+        return QString();
+    }
+    QString band = c.band.toString().toLower();
+    if (band.endsWith('m')) {
+        band.chop(1);
+    }
+    return band;
+}
+
+QString contactMode(const LoggedContact &c)
+{
+    // ADIF files FT4 under MODE=MFSK SUBMODE=FT4.
+    if (c.mode.equals("MFSK") && !c.submode.isEmpty()) {
+        return c.submode.toString().toUpper();
+    }
+    return c.mode.toString().toUpper();
+}
+
+// N1MM+ sends one flat document per datagram:
+//   <contactinfo> ... <call>K1ABC</call> ... <txfreq>1402500</txfreq> ... </contactinfo>
+// txfreq/rxfreq are in units of 10 Hz. Leaf elements have no attributes.
+bool parseN1mmContact(const QByteArray &datagram, LoggedContact *contact)
+{
+    const char *p = datagram.constData();
+    const char *end = p + datagram.size();
+    Span rxfreq;
+    Span txfreq;
+
+    while (p < end) {
+        const char *lt = static_cast<const char *>(memchr(p, '<', size_t(end - p)));
+        if (!lt) {
+            break;
+        }
+        const char *gt = static_cast<const char *>(memchr(lt, '>', size_t(end - lt)));
+        if (!gt) {
+            break;
+        }
+        p = gt + 1;
+        if (lt[1] == '/' || lt[1] == '?' || lt[1] == '!' || gt[-1] == '/') {
+            continue;       // end tag, prolog, comment or empty element
+        }
+
+        const Span name{lt + 1, int(gt - lt - 1)};
+        const char *textEnd = static_cast<const char *>(memchr(p, '<', size_t(end - p)));
+        if (!textEnd) {
+            break;
+        }
+        const Span text{p, int(textEnd - p)};
+
+        if (name.equals("call"))         contact->call = text;
+        else if (name.equals("band"))    contact->band = text;
+        else if (name.equals("mode"))    contact->mode = text;
+        else if (name.equals("txfreq"))  txfreq = text;
+        else if (name.equals("rxfreq"))  rxfreq = text;
+    }
+
+    contact->freqHz = parseHz(txfreq.isEmpty() ? rxfreq : txfreq, 10.0);
+    return !contact->call.isEmpty();
+}
+
+// ADIF: <CALL:5>K1ABC<BAND:3>20m<MODE:2>CW<FREQ:6>14.025<EOR>. An optional
+// header ends at <EOH>. Returns the contacts in the datagram, which may be
+// several records.
+QVector<LoggedContact> parseAdifContacts(const QByteArray &datagram)
+{
+    QVector<LoggedContact> contacts;
+    const char *p = datagram.constData();
+    const char *end = p + datagram.size();
+    LoggedContact current;
+    Span freq;
+
+    while (p < end) {
+        const char *lt = static_cast<const char *>(memchr(p, '<', size_t(end - p)));
+        if (!lt) {
+            break;
+        }
+        const char *gt = static_cast<const char *>(memchr(lt, '>', size_t(end - lt)));
+        if (!gt) {
+            break;
+        }
+        p = gt + 1;
+
+        // NAME[:LENGTH[:TYPE]]
+        const char *colon = static_cast<const char *>(memchr(lt, ':', size_t(gt - lt)));
+        const Span name{lt + 1, int((colon ? colon : gt) - lt - 1)};
+        if (!colon) {
+            if (name.equals("EOR")) {
+                current.freqHz = parseHz(freq, 1e6);
+                if (!current.call.isEmpty()) {
+                    contacts.append(current);
+                }
+                current = LoggedContact();
+                freq = Span();
+            } else if (name.equals("EOH")) {
+                current = LoggedContact();
+                freq = Span();
+            }
+            continue;
+        }
+
+        int length = 0;
+        for (const char *d = colon + 1; d < gt && *d >= '0' && *d <= '9'; ++d) {
+            length = length * 10 + (*d - '0');
+        }
+        length = qMin(length, int(end - p));
+        const Span value{p, length};
+        p += length;
+
+        if (name.equals("CALL"))          current.call = value;
+        else if (name.equals("BAND"))     current.band = value;
+        else if (name.equals("MODE"))     current.mode = value;
+        else if (name.equals("SUBMODE"))  current.submode = value;
+        else if (name.equals("FREQ"))     freq = value;
+    }
+    return contacts;
+}
+
+} // namespace
+
+bool UdpReceiver::decodeLoggerDatagram(const QByteArray &datagram, const QHostAddress &sender)
+{
+    QVector<LoggedContact> contacts;
+    QString id;
+    bool bandInMhz = false;
+
+    // N1MM+ also broadcasts RadioInfo, spots and contactdelete; only new and
+    // edited contacts matter here.
+    if (datagram.contains("<contactinfo") || datagram.contains("<contactreplace")) {
+        LoggedContact contact;
+        if (parseN1mmContact(datagram, &contact)) {
+            contacts.append(contact);
+        }
+        id = "n1mm:" + sender.toString();
+        bandInMhz = true;
+    } else if (datagram.toLower().contains("<eor>")) {     // ADIF tags are case-insensitive
+        contacts = parseAdifContacts(datagram);
+        id = "adif:" + sender.toString();
+    } else {
+        return false;
+    }
+
+    for (const LoggedContact &contact : contacts) {
+        const QString call = contact.call.toString().toUpper();
+        const QString band = contactBand(contact, bandInMhz);
+        const QString mode = contactMode(contact);
+        if (band.isEmpty() || mode.isEmpty()) {
+            qDebug().noquote() << "Logged QSO ignored (band/mode unknown) from" << id << "call=" << call;
+            continue;
+        }
+        emit qsoLogged(id, call, band, mode);
+    }
+    return true;
+}
+
+void UdpReceiver::decodeWsjtxDatagram(const QByteArray &datagram, const QHostAddress &sender, quint16 senderPort)
 {
     QDataStream ds(datagram);
     ds.setByteOrder(QDataStream::BigEndian);
@@ -218,19 +495,48 @@ static void decodeWsjtxDatagram(const QByteArray &datagram, UdpReceiver *self)
     ds >> magic >> schema >> type;
 
     if (magic != 0xadbccbda) {
-        qDebug() << "Not WSJT-X. First bytes:" << datagram.left(16).toHex(' ');
+        if (!decodeLoggerDatagram(datagram, sender)) {
+            qDebug() << "Not WSJT-X. First bytes:" << datagram.left(16).toHex(' ');
+        }
         return;
     }
 
     setStreamVersionFromSchema(ds, schema);
 
     const QString id = readUtf8(ds);
+    if (id.isEmpty()) {
+        return;
+    }
 
     // qDebug().noquote() << "WSJT-X schema=" << schema << "type=" << type << "id=" << id;
 
+    if (type == 6) {            // Close
+        if (m_instances.remove(id)) {
+            qDebug().noquote() << "WSJT-X instance closed:" << id;
+            emit instanceClosed(id);
+        }
+        return;
+    }
+
+    const bool known = m_instances.contains(id);
+    WsjtxInstance &inst = m_instances[id];
+    inst.id = id;
+    inst.address = sender;
+    inst.port = senderPort;
+    inst.lastSeen = QDateTime::currentDateTimeUtc();
+    if (!known) {
+        qDebug().noquote() << "WSJT-X instance:" << id << "from" << sender.toString() << ":" << senderPort;
+    }
+
     switch (type) {
-    case 5:  decodeType5_QsoLoggedAndEmit(ds, self); break;   // QSO Logged
-    // case 6:  decodeType6_Close(ds, id); break;       // Close
+    case 0:
+        if (decodeType0_Heartbeat(ds, inst)) emit instanceUpdated(id);
+        break;
+    case 1:
+        if (decodeType1_Status(ds, inst)) emit instanceUpdated(id);
+        break;
+    case 2:  decodeType2_DecodeAndEmit(ds, id, this); break;      // Decode
+    case 5:  decodeType5_QsoLoggedAndEmit(ds, id, this); break;   // QSO Logged
     default:
         // qDebug() << "Unhandled type" << type
         //          << "remaining bytes" << (ds.device() ? ds.device()->bytesAvailable() : -1);
@@ -241,52 +547,199 @@ static void decodeWsjtxDatagram(const QByteArray &datagram, UdpReceiver *self)
 UdpReceiver::UdpReceiver(QObject *parent)
     : QObject(parent)
 {
-    connect(&m_socket, &QUdpSocket::readyRead, this, &UdpReceiver::onReadyRead);
+    connect(&m_pruneTimer, &QTimer::timeout, this, &UdpReceiver::pruneStaleInstances);
+    m_pruneTimer.start(15 * 1000);
 }
 
-bool UdpReceiver::start(quint16 port)
+bool UdpReceiver::addEndpoint(const QHostAddress &address, quint16 port)
 {
-    // Bind only to localhost (127.0.0.1). If you want to accept from any host,
-    // use QHostAddress::AnyIPv4 instead.
-    const bool ok = m_socket.bind(
-        QHostAddress::LocalHost,
+    const bool multicast = address.isMulticast();
+    auto *socket = new QUdpSocket(this);
+
+    const bool ok = socket->bind(
+        multicast ? (address.protocol() == QAbstractSocket::IPv6Protocol
+                         ? QHostAddress(QHostAddress::AnyIPv6)
+                         : QHostAddress(QHostAddress::AnyIPv4))
+                  : address,
         port,
         QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint
         );
 
     if (!ok) {
-        qWarning() << "UDP bind failed on 127.0.0.1:" << port << "-" << m_socket.errorString();
+        qWarning() << "UDP bind failed on" << address.toString() << ":" << port << "-" << socket->errorString();
+        delete socket;
         return false;
     }
 
-    qDebug() << "UDP listening on 127.0.0.1:" << port;
+    if (multicast) {
+        // WSJT-X sends on a chosen interface (often loopback); join on all of them.
+        int joined = 0;
+        const auto interfaces = QNetworkInterface::allInterfaces();
+        for (const QNetworkInterface &iface : interfaces) {
+            const auto flags = iface.flags();
+            if (!(flags & QNetworkInterface::IsUp) || !(flags & QNetworkInterface::CanMulticast)) {
+                continue;
+            }
+            if (socket->joinMulticastGroup(address, iface)) {
+                ++joined;
+            }
+        }
+        if (joined == 0 && !socket->joinMulticastGroup(address)) {
+            qWarning() << "UDP multicast join failed for" << address.toString() << "-" << socket->errorString();
+            delete socket;
+            return false;
+        }
+    }
+
+    connect(socket, &QUdpSocket::readyRead, this, &UdpReceiver::onReadyRead);
+    m_sockets.append(socket);
+
+    qDebug() << "UDP listening on" << address.toString() << ":" << port << (multicast ? "(multicast)" : "");
     return true;
 }
 
+bool UdpReceiver::parseEndpoint(const QString &text, QHostAddress *address, quint16 *port)
+{
+    const QString t = text.trimmed();
+    const int colon = t.lastIndexOf(':');
+    QString host = colon >= 0 ? t.left(colon) : QString("127.0.0.1");
+    const QString portText = colon >= 0 ? t.mid(colon + 1) : t;
+
+    if (host.startsWith('[') && host.endsWith(']')) {
+        host = host.mid(1, host.size() - 2);
+    }
+    if (host.compare("localhost", Qt::CaseInsensitive) == 0) {
+        host = "127.0.0.1";
+    }
+
+    bool ok = false;
+    const uint p = portText.toUInt(&ok);
+    if (!ok || p == 0 || p > 65535) {
+        return false;
+    }
+
+    QHostAddress a;
+    if (!a.setAddress(host)) {
+        return false;
+    }
+
+    *address = a;
+    *port = quint16(p);
+    return true;
+}
+
+QString UdpReceiver::callerFromMessage(const QString &message)
+{
+    // "CQ K1ABC FN42", "CQ DX K1ABC FN42", "W9XYZ K1ABC -11", "K1ABC RR73; ..."
+    const QStringList tokens = message.split(' ', Qt::SkipEmptyParts);
+    if (tokens.isEmpty()) {
+        return QString();
+    }
+
+    int i = 1;
+    if (tokens[0] == "CQ" || tokens[0] == "QRZ" || tokens[0] == "DE") {
+        // Optional directed-CQ modifier ("DX", "NA", "POTA", "290")
+        if (tokens.size() > 2) {
+            const QString &mod = tokens[1];
+            bool allLetters = mod.size() <= 4;
+            bool allDigits = mod.size() == 3;
+            for (const QChar ch : mod) {
+                allLetters = allLetters && ch.isLetter();
+                allDigits = allDigits && ch.isDigit();
+            }
+            if (allLetters || allDigits) {
+                i = 2;
+            }
+        }
+    }
+    if (i >= tokens.size()) {
+        return QString();
+    }
+
+    QString call = tokens[i];
+    if (call.startsWith('<') && call.endsWith('>')) {
+        call = call.mid(1, call.size() - 2);
+    }
+    if (call == "..." || call.size() < 3) {
+        return QString();   // unresolved hashed call
+    }
+
+    bool hasDigit = false;
+    bool hasLetter = false;
+    for (const QChar ch : call) {
+        hasDigit = hasDigit || ch.isDigit();
+        hasLetter = hasLetter || ch.isLetter();
+    }
+    return (hasDigit && hasLetter) ? call.toUpper() : QString();
+}
+
+qint64 UdpReceiver::sendReply(const QString &instanceId, const QTime &time, int snr, double deltaTime,
+                              quint32 deltaFreq, const QString &mode, const QString &message,
+                              bool lowConfidence, quint8 modifiers)
+{
+    const auto it = m_instances.constFind(instanceId);
+    if (it == m_instances.constEnd() || it->port == 0) {
+        return -1;
+    }
+
+    // Answer in the newest schema both sides know; 3 if no heartbeat yet.
+    const quint32 schema = it->maxSchema ? qMin<quint32>(it->maxSchema, 3) : 3;
+
+    QByteArray datagram;
+    QDataStream ds(&datagram, QIODevice::WriteOnly);
+    ds.setByteOrder(QDataStream::BigEndian);
+    setStreamVersionFromSchema(ds, schema);
+    ds << quint32(0xadbccbda) << schema << quint32(4) << instanceId.toUtf8()
+       << time << qint32(snr) << deltaTime << deltaFreq
+       << mode.toUtf8() << message.toUtf8() << lowConfidence << modifiers;
+
+    if (m_replySocket.writeDatagram(datagram, it->address, it->port) != datagram.size()) {
+        qWarning() << "Reply to" << instanceId << "failed:" << m_replySocket.errorString();
+        return -1;
+    }
+    return m_received.isValid() ? m_received.nsecsElapsed() / 1000 : 0;
+}
+
+void UdpReceiver::pruneStaleInstances()
+{
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    for (auto it = m_instances.begin(); it != m_instances.end();) {
+        if (it->lastSeen.msecsTo(now) > kInstanceTimeoutMs) {
+            const QString id = it.key();
+            it = m_instances.erase(it);
+            qDebug().noquote() << "WSJT-X instance timed out:" << id;
+            emit instanceClosed(id);
+        } else {
+            ++it;
+        }
+    }
+}
+
 void UdpReceiver::onReadyRead()
 {
-    while (m_socket.hasPendingDatagrams()) {
+    auto *socket = qobject_cast<QUdpSocket *>(sender());
+    if (!socket) {
+        return;
+    }
+
+    while (socket->hasPendingDatagrams()) {
         QByteArray datagram;
-        datagram.resize(int(m_socket.pendingDatagramSize()));
+        datagram.resize(int(socket->pendingDatagramSize()));
 
         QHostAddress sender;
         quint16 senderPort = 0;
 
-        const qint64 n = m_socket.readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
+        const qint64 n = socket->readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
         if (n < 0) {
-            qWarning() << "readDatagram failed:" << m_socket.errorString();
+            qWarning() << "readDatagram failed:" << socket->errorString();
             continue;
         }
 
-        // Try to print as UTF-8 text; also show raw bytes length.
-        const QString text = QString::fromUtf8(datagram);
-
         // qDebug().noquote()
         //     << "UDP from" << sender.toString() << ":" << senderPort
-        //     << "len=" << datagram.size()
-        //     << "msg=" << text.trimmed();
+        //     << "len=" << datagram.size();
 
-        decodeWsjtxDatagram(datagram, this);
+        m_received.start();
+        decodeWsjtxDatagram(datagram, sender, senderPort);
     }
 }
-
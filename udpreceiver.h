@@ -4,6 +4,32 @@
 #include <QObject>
 #include <QUdpSocket>
 #include <QHostAddress>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QTime>
+#include <QHash>
+#include <QList>
+#include <QTimer>
+
+// Last known state of one WSJT-X / JTDX instance, keyed by its "id".
+struct WsjtxInstance {
+    QString id;
+    QHostAddress address;       // sender of the last datagram
+    quint16 port = 0;
+    quint32 maxSchema = 0;
+    QString version;
+    quint64 dialFreqHz = 0;
+    QString mode;
+    QString deCall;
+    QString deGrid;
+    QString dxCall;             // station being worked, empty if none
+    bool txEnabled = false;     // "Enable Tx" is on
+    bool transmitting = false;
+    bool decoding = false;
+    QDateTime lastHeartbeat;
+    QDateTime lastStatus;
+    QDateTime lastSeen;
+};
 
 class UdpReceiver : public QObject
 {
@@ -11,15 +37,49 @@ class UdpReceiver : public QObject
 public:
     explicit UdpReceiver(QObject *parent = nullptr);
 
-    // Start listening on localhost:2237
-    bool start(quint16 port = 2237);
+    // Listen on one more endpoint. A multicast group address is joined on
+    // every multicast-capable interface; anything else is bound directly.
+    bool addEndpoint(const QHostAddress &address, quint16 port);
+
+    // "host:port", "port" or "239.255.0.1:2237"
+    static bool parseEndpoint(const QString &text, QHostAddress *address, quint16 *port);
+
+    // Band name in meters ("2" ... "160") for a frequency, empty if outside the bands.
+    static QString bandFromHz(quint64 hz);
+
+    // Station that sent a decoded FT8/FT4 message, or empty if unknown.
+    static QString callerFromMessage(const QString &message);
+
+    const QHash<QString, WsjtxInstance> &instances() const { return m_instances; }
+
+    // Sends a Reply (type 4) to an instance, as if the operator double-clicked
+    // the decode. The decode fields must be echoed exactly as received.
+    // Returns the time since the triggering datagram arrived, in microseconds,
+    // or -1 if the instance is unknown or the send failed.
+    qint64 sendReply(const QString &instanceId, const QTime &time, int snr, double deltaTime, quint32 deltaFreq,
+                     const QString &mode, const QString &message, bool lowConfidence, quint8 modifiers = 0);
+
 signals:
-    void qsoLogged(const QString &call, const QString &band, const QString &mode);
+    // Also emitted for N1MM+ and ADIF loggers, with instance "n1mm:<host>" or "adif:<host>".
+    void qsoLogged(const QString &instanceId, const QString &call, const QString &band, const QString &mode);
+    void decoded(const QString &instanceId, const QTime &time, int snr, double deltaTime, quint32 deltaFreq,
+                 const QString &mode, const QString &message, bool lowConfidence);
+    void instanceUpdated(const QString &instanceId);
+    void instanceClosed(const QString &instanceId);
 private slots:
     void onReadyRead();
+    void pruneStaleInstances();
 
 private:
-    QUdpSocket m_socket;
+    void decodeWsjtxDatagram(const QByteArray &datagram, const QHostAddress &sender, quint16 senderPort);
+    // N1MM+ contactinfo XML or ADIF records; false if the datagram is neither.
+    bool decodeLoggerDatagram(const QByteArray &datagram, const QHostAddress &sender);
+
+    QList<QUdpSocket *> m_sockets;
+    QUdpSocket m_replySocket;
+    QElapsedTimer m_received;       // started when the current datagram was read
+    QHash<QString, WsjtxInstance> m_instances;
+    QTimer m_pruneTimer;
 };
 
 #endif // UDPRECEIVER_H